@@ -1,12 +1,50 @@
 #include <iostream>
 #include <vector>
 #include <set>
+#include <map>
 #include <string>
 #include <algorithm>
 #include <iomanip>
 #include <random>
 #include <chrono>
 #include <numeric>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <array>
+#include <unordered_set>
+#include <unordered_map>
+#include <deque>
+#include <queue>
+#include <memory>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <cstdlib>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define TESTORES_X86_SIMD 1
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <cerrno>
+#define TESTORES_POSIX 1
+#endif
+
+#ifdef __linux__
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#define TESTORES_PERF 1
+#endif
 
 using namespace std;
 
@@ -47,6 +85,663 @@ void imprimir_matriz(const Matriz& M) {
     }
 }
 
+// ======================================================================
+// ========================= PERFILADO POR FASES ========================
+// ======================================================================
+
+// Con TESTORES_PERFIL=tabla o TESTORES_PERFIL=json cada fase marcada con
+// FasePerfil acumula su tiempo y, en Linux, cuatro contadores de hardware
+// leidos con perf_event_open: ciclos, instrucciones, fallos de cache y
+// fallos de prediccion de saltos. Si el sistema no los da (sin PMU, por
+// perf_event_paranoid o fuera de Linux) se reporta solo el tiempo.
+//
+// Los contadores siguen a los hilos que se crean despues de abrirlos y se
+// suman al terminar cada hilo. Una fase anidada (filasUnicas dentro de
+// aMatrizBasica) se cuenta tambien en la externa.
+
+const int EVENTOS_PERFIL = 4;
+const char* const NOMBRES_EVENTOS[EVENTOS_PERFIL] = {"ciclos", "instrucciones", "fallos_cache", "fallos_salto"};
+
+struct Perfil {
+    struct Fase {
+        string nombre;
+        long long veces = 0;
+        double ms = 0;
+        long long cuenta[EVENTOS_PERFIL] = {0, 0, 0, 0};   // -1 = evento no disponible
+    };
+
+    int modo = 0;                       // 0 apagado, 1 tabla, 2 json
+    int fd[EVENTOS_PERFIL] = {-1, -1, -1, -1};
+    bool hw = false;
+    string motivo;                      // por que no hay contadores
+    vector<Fase> fases;                 // en el orden en que aparecieron
+    map<string, size_t> indice;
+    mutex m;
+
+    Perfil() {
+        string pedido;
+        if (const char* env = getenv("TESTORES_PERFIL")) pedido = env;
+        modo = pedido == "tabla" ? 1 : pedido == "json" ? 2 : 0;
+        if (modo) abrir_contadores();
+    }
+
+    ~Perfil() {
+#ifdef TESTORES_PERF
+        for (int e = 0; e < EVENTOS_PERFIL; ++e)
+            if (fd[e] >= 0) close(fd[e]);
+#endif
+    }
+
+    void abrir_contadores() {
+#ifdef TESTORES_PERF
+        const uint64_t eventos[EVENTOS_PERFIL] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                                  PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+        for (int e = 0; e < EVENTOS_PERFIL; ++e) {
+            perf_event_attr a;
+            memset(&a, 0, sizeof(a));
+            a.size = sizeof(a);
+            a.type = PERF_TYPE_HARDWARE;
+            a.config = eventos[e];
+            a.exclude_kernel = 1;
+            a.exclude_hv = 1;
+            a.inherit = 1;
+            a.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            fd[e] = syscall(SYS_perf_event_open, &a, 0, -1, -1, 0);
+            if (fd[e] >= 0) hw = true;
+            else if (motivo.empty()) motivo = string("perf_event_open: ") + strerror(errno);
+        }
+#else
+        motivo = "perf_event_open no existe en este sistema";
+#endif
+    }
+
+    // Valor actual de cada contador, escalado si el nucleo los multiplexo
+    void leer(long long v[EVENTOS_PERFIL]) const {
+        for (int e = 0; e < EVENTOS_PERFIL; ++e) {
+            v[e] = -1;
+#ifdef TESTORES_PERF
+            uint64_t buf[3];
+            if (fd[e] < 0 || read(fd[e], buf, sizeof(buf)) != (ssize_t)sizeof(buf)) continue;
+            v[e] = (buf[2] && buf[2] < buf[1]) ? (long long)(double(buf[0]) * buf[1] / buf[2]) : (long long)buf[0];
+#endif
+        }
+    }
+
+    void acumular(const string& nombre, double ms, const long long antes[], const long long despues[]) {
+        lock_guard<mutex> lock(m);
+        auto it = indice.find(nombre);
+        if (it == indice.end()) {
+            it = indice.emplace(nombre, fases.size()).first;
+            fases.emplace_back();
+            fases.back().nombre = nombre;
+        }
+        Fase& f = fases[it->second];
+        f.veces++;
+        f.ms += ms;
+        for (int e = 0; e < EVENTOS_PERFIL; ++e)
+            f.cuenta[e] = (antes[e] < 0 || despues[e] < 0 || f.cuenta[e] < 0)
+                              ? -1 : f.cuenta[e] + (despues[e] - antes[e]);
+    }
+};
+
+Perfil& perfil() {
+    static Perfil p;
+    return p;
+}
+
+// Marca una fase desde su construccion hasta su destruccion o hasta
+// terminar(). Apagado el perfil, solo cuesta una comparacion.
+struct FasePerfil {
+    const char* nombre;
+    int numero;
+    bool activa;
+    chrono::high_resolution_clock::time_point inicio;
+    long long antes[EVENTOS_PERFIL];
+
+    explicit FasePerfil(const char* nombre, int numero = -1)
+        : nombre(nombre), numero(numero), activa(perfil().modo != 0) {
+        if (!activa) return;
+        perfil().leer(antes);
+        inicio = chrono::high_resolution_clock::now();
+    }
+
+    void terminar() {
+        if (!activa) return;
+        activa = false;
+        double ms = chrono::duration<double, milli>(chrono::high_resolution_clock::now() - inicio).count();
+        long long despues[EVENTOS_PERFIL];
+        perfil().leer(despues);
+        string n = nombre;
+        if (numero >= 0) n += " " + to_string(numero);
+        perfil().acumular(n, ms, antes, despues);
+    }
+
+    ~FasePerfil() { terminar(); }
+};
+
+// Imprime lo acumulado desde el ultimo reporte y lo vacia
+void reportar_perfil() {
+    Perfil& p = perfil();
+    if (!p.modo || p.fases.empty()) return;
+
+    auto valor = [](long long v) { return v < 0 ? string("-") : to_string(v); };
+
+    if (p.modo == 2) {
+        cout << "{\"contadores\":" << (p.hw ? "true" : "false");
+        if (!p.motivo.empty()) cout << ",\"motivo\":\"" << p.motivo << "\"";
+        cout << ",\"fases\":[";
+        for (size_t i = 0; i < p.fases.size(); ++i) {
+            auto& f = p.fases[i];
+            cout << (i ? "," : "") << "{\"fase\":\"" << f.nombre << "\",\"veces\":" << f.veces
+                 << ",\"ms\":" << fixed << setprecision(3) << f.ms;
+            for (int e = 0; e < EVENTOS_PERFIL; ++e)
+                cout << ",\"" << NOMBRES_EVENTOS[e] << "\":" << (f.cuenta[e] < 0 ? "null" : to_string(f.cuenta[e]));
+            cout << "}";
+        }
+        cout << "]}\n";
+    } else {
+        cout << "\n===== PERFIL POR FASES =====\n";
+        if (!p.hw) cout << "(contadores de hardware no disponibles: " << p.motivo << "; solo tiempo)\n";
+        cout << left << setw(18) << "fase" << right << setw(7) << "veces" << setw(12) << "ms";
+        if (p.hw)
+            cout << setw(15) << "ciclos" << setw(15) << "instrucciones" << setw(7) << "IPC"
+                 << setw(13) << "fallos cache" << setw(13) << "fallos salto";
+        cout << "\n";
+        for (auto& f : p.fases) {
+            cout << left << setw(18) << f.nombre << right << setw(7) << f.veces
+                 << setw(12) << fixed << setprecision(3) << f.ms;
+            if (p.hw) {
+                cout << setw(15) << valor(f.cuenta[0]) << setw(15) << valor(f.cuenta[1]);
+                if (f.cuenta[0] > 0 && f.cuenta[1] >= 0)
+                    cout << setw(7) << setprecision(2) << double(f.cuenta[1]) / f.cuenta[0];
+                else
+                    cout << setw(7) << "-";
+                cout << setw(13) << valor(f.cuenta[2]) << setw(13) << valor(f.cuenta[3]);
+            }
+            cout << "\n";
+        }
+    }
+    p.fases.clear();
+    p.indice.clear();
+}
+
+// ======================================================================
+// ==================== FILAS EMPAQUETADAS Y KERNELS ====================
+// ======================================================================
+
+// Matriz booleana empaquetada: la columna j de cada fila vive en el bit
+// (j % 64) de la palabra (j / 64). Las filas son contiguas en 'datos' y los
+// bits sobrantes de la ultima palabra siempre valen 0.
+struct MatrizBits {
+    int filas = 0;
+    int columnas = 0;
+    int palabras = 0;
+    vector<uint64_t> datos;
+
+    uint64_t* fila(int i) { return datos.data() + (size_t)i * palabras; }
+    const uint64_t* fila(int i) const { return datos.data() + (size_t)i * palabras; }
+};
+
+inline int palabras_para(int columnas) {
+    return (columnas + 63) / 64;
+}
+
+vector<uint64_t> empaquetar_fila(const vector<int>& fila) {
+    vector<uint64_t> out(palabras_para(fila.size()), 0);
+    for (size_t j = 0; j < fila.size(); ++j)
+        if (fila[j]) out[j >> 6] |= 1ULL << (j & 63);
+    return out;
+}
+
+MatrizBits empaquetar(const Matriz& M) {
+    MatrizBits B;
+    B.filas = M.size();
+    B.columnas = M.empty() ? 0 : M[0].size();
+    B.palabras = palabras_para(B.columnas);
+    B.datos.assign((size_t)B.filas * B.palabras, 0);
+
+    for (int i = 0; i < B.filas; ++i) {
+        uint64_t* f = B.fila(i);
+        for (int j = 0; j < B.columnas; ++j)
+            if (M[i][j]) f[j >> 6] |= 1ULL << (j & 63);
+    }
+    return B;
+}
+
+Matriz desempaquetar(const MatrizBits& B) {
+    Matriz M(B.filas, vector<int>(B.columnas, 0));
+    for (int i = 0; i < B.filas; ++i) {
+        const uint64_t* f = B.fila(i);
+        for (int j = 0; j < B.columnas; ++j)
+            M[i][j] = (f[j >> 6] >> (j & 63)) & 1;
+    }
+    return M;
+}
+
+// Transpone in situ un bloque de 64x64 bits (a[r] bit c pasa a a[c] bit r)
+// intercambiando recursivamente los cuadrantes fuera de la diagonal.
+static void transponer64(uint64_t a[64]) {
+    uint64_t m = 0x00000000FFFFFFFFULL;
+    for (int j = 32; j != 0; j >>= 1, m ^= (m << j)) {
+        for (int k = 0; k < 64; k = ((k | j) + 1) & ~j) {
+            uint64_t t = ((a[k] >> j) ^ a[k | j]) & m;
+            a[k] ^= t << j;
+            a[k | j] ^= t;
+        }
+    }
+}
+
+// Transpuesta por columnas: la fila c del resultado es el conjunto de filas
+// de B que tienen un 1 en la columna c. Se recorre en bloques de 64x64 para
+// que cada bloque quepa en cache.
+MatrizBits transponer(const MatrizBits& B) {
+    MatrizBits T;
+    T.filas = B.columnas;
+    T.columnas = B.filas;
+    T.palabras = palabras_para(T.columnas);
+    T.datos.assign((size_t)T.filas * T.palabras, 0);
+
+    uint64_t bloque[64];
+    for (int rb = 0; rb < T.palabras; ++rb) {
+        int filas_bloque = min(64, B.filas - rb * 64);
+        for (int w = 0; w < B.palabras; ++w) {
+            for (int i = 0; i < 64; ++i)
+                bloque[i] = (i < filas_bloque) ? B.fila(rb * 64 + i)[w] : 0;
+            transponer64(bloque);
+            int cols_bloque = min(64, B.columnas - w * 64);
+            for (int i = 0; i < cols_bloque; ++i)
+                T.fila(w * 64 + i)[rb] = bloque[i];
+        }
+    }
+    return T;
+}
+
+// FNV-1a de 64 bits sobre un bloque de bytes
+uint64_t fnv1a(const void* datos, size_t n, uint64_t h = 1469598103934665603ULL) {
+    const unsigned char* p = (const unsigned char*)datos;
+    for (size_t i = 0; i < n; ++i) {
+        h ^= p[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+// Huella de contenido de una matriz empaquetada (dimensiones y bits)
+uint64_t huella_matriz(const MatrizBits& B) {
+    uint32_t dim[2] = {uint32_t(B.filas), uint32_t(B.columnas)};
+    uint64_t h = fnv1a(dim, sizeof(dim));
+    return fnv1a(B.datos.data(), B.datos.size() * sizeof(uint64_t), h);
+}
+
+inline int popcount64(uint64_t x) {
+#if defined(__GNUC__)
+    return __builtin_popcountll(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return int((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+// Indice del bit menos significativo en 1 (x != 0)
+inline int ctz64(uint64_t x) {
+#if defined(__GNUC__)
+    return __builtin_ctzll(x);
+#else
+    int n = 0;
+    while (!(x & 1)) { x >>= 1; n++; }
+    return n;
+#endif
+}
+
+// Indice del bit mas significativo en 1 (x != 0)
+inline int msb64(uint64_t x) {
+#if defined(__GNUC__)
+    return 63 - __builtin_clzll(x);
+#else
+    int n = 0;
+    while (x >>= 1) n++;
+    return n;
+#endif
+}
+
+// Mascara de bits validos en la ultima palabra de un vector de n bits
+inline uint64_t mascara_ultima(int n) {
+    return (n & 63) ? (1ULL << (n & 63)) - 1 : ~0ULL;
+}
+
+// Tabla de kernels sobre filas empaquetadas. Todas reciben punteros a
+// 'n' palabras de 64 bits; se elige una implementacion al arrancar segun
+// la CPU (ver kernels()).
+struct KernelsBits {
+    const char* nombre;
+    // r es subfila estricta de s: r & ~s == 0 y r != s
+    bool (*es_subfila)(const uint64_t* r, const uint64_t* s, int n);
+    // a & b != 0
+    bool (*interseca)(const uint64_t* a, const uint64_t* b, int n);
+    int (*popcount)(const uint64_t* a, int n);
+    int (*popcount_and)(const uint64_t* a, const uint64_t* b, int n);
+    // Todas las filas tienen al menos un 1 en las columnas de cand
+    bool (*cubre_filas)(const uint64_t* filas, int nfilas, int palabras, const uint64_t* cand);
+};
+
+// ------------------------------ Escalar -------------------------------
+
+static bool kb_escalar_es_subfila(const uint64_t* r, const uint64_t* s, int n) {
+    bool menorEstricto = false;
+    for (int i = 0; i < n; ++i) {
+        if (r[i] & ~s[i]) return false;
+        if (s[i] & ~r[i]) menorEstricto = true;
+    }
+    return menorEstricto;
+}
+
+static bool kb_escalar_interseca(const uint64_t* a, const uint64_t* b, int n) {
+    for (int i = 0; i < n; ++i)
+        if (a[i] & b[i]) return true;
+    return false;
+}
+
+static int kb_escalar_popcount(const uint64_t* a, int n) {
+    int c = 0;
+    for (int i = 0; i < n; ++i) c += popcount64(a[i]);
+    return c;
+}
+
+static int kb_escalar_popcount_and(const uint64_t* a, const uint64_t* b, int n) {
+    int c = 0;
+    for (int i = 0; i < n; ++i) c += popcount64(a[i] & b[i]);
+    return c;
+}
+
+static bool kb_escalar_cubre_filas(const uint64_t* filas, int nfilas, int palabras, const uint64_t* cand) {
+    for (int i = 0; i < nfilas; ++i)
+        if (!kb_escalar_interseca(filas + (size_t)i * palabras, cand, palabras))
+            return false;
+    return true;
+}
+
+#ifdef TESTORES_X86_SIMD
+
+// --------------------------- SSE4.2 / POPCNT --------------------------
+
+__attribute__((target("sse4.2,popcnt")))
+static bool kb_sse42_es_subfila(const uint64_t* r, const uint64_t* s, int n) {
+    bool menorEstricto = false;
+    int i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128i vr = _mm_loadu_si128((const __m128i*)(r + i));
+        __m128i vs = _mm_loadu_si128((const __m128i*)(s + i));
+        if (!_mm_testc_si128(vs, vr)) return false;      // r & ~s != 0
+        if (!_mm_testc_si128(vr, vs)) menorEstricto = true;
+    }
+    for (; i < n; ++i) {
+        if (r[i] & ~s[i]) return false;
+        if (s[i] & ~r[i]) menorEstricto = true;
+    }
+    return menorEstricto;
+}
+
+__attribute__((target("sse4.2,popcnt")))
+static bool kb_sse42_interseca(const uint64_t* a, const uint64_t* b, int n) {
+    int i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i*)(b + i));
+        if (!_mm_testz_si128(va, vb)) return true;
+    }
+    for (; i < n; ++i)
+        if (a[i] & b[i]) return true;
+    return false;
+}
+
+__attribute__((target("sse4.2,popcnt")))
+static int kb_sse42_popcount(const uint64_t* a, int n) {
+    long long c = 0;
+    for (int i = 0; i < n; ++i) c += _mm_popcnt_u64(a[i]);
+    return int(c);
+}
+
+__attribute__((target("sse4.2,popcnt")))
+static int kb_sse42_popcount_and(const uint64_t* a, const uint64_t* b, int n) {
+    long long c = 0;
+    for (int i = 0; i < n; ++i) c += _mm_popcnt_u64(a[i] & b[i]);
+    return int(c);
+}
+
+__attribute__((target("sse4.2,popcnt")))
+static bool kb_sse42_cubre_filas(const uint64_t* filas, int nfilas, int palabras, const uint64_t* cand) {
+    for (int i = 0; i < nfilas; ++i)
+        if (!kb_sse42_interseca(filas + (size_t)i * palabras, cand, palabras))
+            return false;
+    return true;
+}
+
+// -------------------------------- AVX2 --------------------------------
+
+__attribute__((target("avx2,popcnt")))
+static bool kb_avx2_es_subfila(const uint64_t* r, const uint64_t* s, int n) {
+    bool menorEstricto = false;
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i vr = _mm256_loadu_si256((const __m256i*)(r + i));
+        __m256i vs = _mm256_loadu_si256((const __m256i*)(s + i));
+        if (!_mm256_testc_si256(vs, vr)) return false;
+        if (!_mm256_testc_si256(vr, vs)) menorEstricto = true;
+    }
+    for (; i < n; ++i) {
+        if (r[i] & ~s[i]) return false;
+        if (s[i] & ~r[i]) menorEstricto = true;
+    }
+    return menorEstricto;
+}
+
+__attribute__((target("avx2,popcnt")))
+static bool kb_avx2_interseca(const uint64_t* a, const uint64_t* b, int n) {
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i*)(b + i));
+        if (!_mm256_testz_si256(va, vb)) return true;
+    }
+    for (; i < n; ++i)
+        if (a[i] & b[i]) return true;
+    return false;
+}
+
+// Cuenta de bits por bytes con una tabla de 16 entradas (pshufb sobre
+// cada nibble) y suma horizontal con vpsadbw: 4 palabras por iteracion,
+// sin sacar los valores del registro.
+__attribute__((target("avx2,popcnt")))
+static inline __m256i avx2_popcount_bytes(__m256i v) {
+    const __m256i tabla = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                           0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+    __m256i bajos = _mm256_shuffle_epi8(tabla, _mm256_and_si256(v, nibble));
+    __m256i altos = _mm256_shuffle_epi8(tabla, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble));
+    return _mm256_sad_epu8(_mm256_add_epi8(bajos, altos), _mm256_setzero_si256());
+}
+
+__attribute__((target("avx2,popcnt")))
+static long long avx2_suma_epi64(__m256i acc) {
+    return _mm256_extract_epi64(acc, 0) + _mm256_extract_epi64(acc, 1)
+         + _mm256_extract_epi64(acc, 2) + _mm256_extract_epi64(acc, 3);
+}
+
+__attribute__((target("avx2,popcnt")))
+static int kb_avx2_popcount(const uint64_t* a, int n) {
+    __m256i acc = _mm256_setzero_si256();
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+        acc = _mm256_add_epi64(acc, avx2_popcount_bytes(_mm256_loadu_si256((const __m256i*)(a + i))));
+    long long c = avx2_suma_epi64(acc);
+    for (; i < n; ++i) c += _mm_popcnt_u64(a[i]);
+    return int(c);
+}
+
+__attribute__((target("avx2,popcnt")))
+static int kb_avx2_popcount_and(const uint64_t* a, const uint64_t* b, int n) {
+    __m256i acc = _mm256_setzero_si256();
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i v = _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(a + i)),
+                                     _mm256_loadu_si256((const __m256i*)(b + i)));
+        acc = _mm256_add_epi64(acc, avx2_popcount_bytes(v));
+    }
+    long long c = avx2_suma_epi64(acc);
+    for (; i < n; ++i) c += _mm_popcnt_u64(a[i] & b[i]);
+    return int(c);
+}
+
+__attribute__((target("avx2,popcnt")))
+static bool kb_avx2_cubre_filas(const uint64_t* filas, int nfilas, int palabras, const uint64_t* cand) {
+    if (palabras <= 4) {
+        // El candidato cabe en un registro: una carga por fila y un vptest.
+        alignas(32) uint64_t c[4] = {0, 0, 0, 0};
+        for (int w = 0; w < palabras; ++w) c[w] = cand[w];
+        __m256i vc = _mm256_load_si256((const __m256i*)c);
+        alignas(32) uint64_t f[4] = {0, 0, 0, 0};
+        for (int i = 0; i < nfilas; ++i) {
+            const uint64_t* fila = filas + (size_t)i * palabras;
+            for (int w = 0; w < palabras; ++w) f[w] = fila[w];
+            if (_mm256_testz_si256(_mm256_load_si256((const __m256i*)f), vc)) return false;
+        }
+        return true;
+    }
+    for (int i = 0; i < nfilas; ++i)
+        if (!kb_avx2_interseca(filas + (size_t)i * palabras, cand, palabras))
+            return false;
+    return true;
+}
+
+// ------------------------------- AVX-512 ------------------------------
+
+// Los intrinsecos AVX-512 de GCC 12 disparan falsos avisos de variables sin
+// inicializar dentro de sus propias cabeceras.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+__attribute__((target("avx512f,avx512vpopcntdq,popcnt")))
+static bool kb_avx512_es_subfila(const uint64_t* r, const uint64_t* s, int n) {
+    bool menorEstricto = false;
+    for (int i = 0; i < n; i += 8) {
+        __mmask8 m = (n - i >= 8) ? (__mmask8)0xFF : (__mmask8)((1u << (n - i)) - 1);
+        __m512i vr = _mm512_maskz_loadu_epi64(m, r + i);
+        __m512i vs = _mm512_maskz_loadu_epi64(m, s + i);
+        if (_mm512_test_epi64_mask(_mm512_andnot_si512(vs, vr), _mm512_set1_epi64(-1))) return false;
+        if (_mm512_test_epi64_mask(_mm512_andnot_si512(vr, vs), _mm512_set1_epi64(-1))) menorEstricto = true;
+    }
+    return menorEstricto;
+}
+
+__attribute__((target("avx512f,avx512vpopcntdq,popcnt")))
+static bool kb_avx512_interseca(const uint64_t* a, const uint64_t* b, int n) {
+    for (int i = 0; i < n; i += 8) {
+        __mmask8 m = (n - i >= 8) ? (__mmask8)0xFF : (__mmask8)((1u << (n - i)) - 1);
+        if (_mm512_test_epi64_mask(_mm512_maskz_loadu_epi64(m, a + i),
+                                   _mm512_maskz_loadu_epi64(m, b + i)))
+            return true;
+    }
+    return false;
+}
+
+__attribute__((target("avx512f,avx512vpopcntdq,popcnt")))
+static int kb_avx512_popcount(const uint64_t* a, int n) {
+    __m512i acc = _mm512_setzero_si512();
+    for (int i = 0; i < n; i += 8) {
+        __mmask8 m = (n - i >= 8) ? (__mmask8)0xFF : (__mmask8)((1u << (n - i)) - 1);
+        acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(_mm512_maskz_loadu_epi64(m, a + i)));
+    }
+    return int(_mm512_reduce_add_epi64(acc));
+}
+
+__attribute__((target("avx512f,avx512vpopcntdq,popcnt")))
+static int kb_avx512_popcount_and(const uint64_t* a, const uint64_t* b, int n) {
+    __m512i acc = _mm512_setzero_si512();
+    for (int i = 0; i < n; i += 8) {
+        __mmask8 m = (n - i >= 8) ? (__mmask8)0xFF : (__mmask8)((1u << (n - i)) - 1);
+        __m512i v = _mm512_and_si512(_mm512_maskz_loadu_epi64(m, a + i),
+                                     _mm512_maskz_loadu_epi64(m, b + i));
+        acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(v));
+    }
+    return int(_mm512_reduce_add_epi64(acc));
+}
+
+__attribute__((target("avx512f,avx512vpopcntdq,popcnt")))
+static bool kb_avx512_cubre_filas(const uint64_t* filas, int nfilas, int palabras, const uint64_t* cand) {
+    if (palabras <= 8) {
+        // Hasta 512 columnas: candidato en un registro, una carga enmascarada
+        // y un vptestmq por fila.
+        __mmask8 m = (__mmask8)((1u << palabras) - 1);
+        __m512i vc = _mm512_maskz_loadu_epi64(m, cand);
+        for (int i = 0; i < nfilas; ++i)
+            if (!_mm512_test_epi64_mask(_mm512_maskz_loadu_epi64(m, filas + (size_t)i * palabras), vc))
+                return false;
+        return true;
+    }
+    for (int i = 0; i < nfilas; ++i)
+        if (!kb_avx512_interseca(filas + (size_t)i * palabras, cand, palabras))
+            return false;
+    return true;
+}
+
+#pragma GCC diagnostic pop
+
+#endif // TESTORES_X86_SIMD
+
+// Niveles que soporta esta CPU, de menor a mayor; el primero es siempre
+// el escalar.
+vector<KernelsBits> kernels_disponibles() {
+    vector<KernelsBits> v;
+    v.push_back({ "escalar", kb_escalar_es_subfila, kb_escalar_interseca,
+                  kb_escalar_popcount, kb_escalar_popcount_and, kb_escalar_cubre_filas });
+#ifdef TESTORES_X86_SIMD
+    __builtin_cpu_init();
+    bool sse42 = __builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt");
+    bool avx2 = sse42 && __builtin_cpu_supports("avx2");
+    bool avx512 = avx2 && __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vpopcntdq");
+
+    if (sse42)
+        v.push_back({ "sse42", kb_sse42_es_subfila, kb_sse42_interseca,
+                      kb_sse42_popcount, kb_sse42_popcount_and, kb_sse42_cubre_filas });
+    if (avx2)
+        v.push_back({ "avx2", kb_avx2_es_subfila, kb_avx2_interseca,
+                      kb_avx2_popcount, kb_avx2_popcount_and, kb_avx2_cubre_filas });
+    if (avx512)
+        v.push_back({ "avx512", kb_avx512_es_subfila, kb_avx512_interseca,
+                      kb_avx512_popcount, kb_avx512_popcount_and, kb_avx512_cubre_filas });
+#endif
+    return v;
+}
+
+// Elige la mejor variante disponible. La variable de entorno TESTORES_SIMD
+// (escalar, sse42, avx2, avx512) permite forzar un nivel inferior; se usa
+// el mejor nivel disponible que no supere al pedido. Un valor desconocido
+// se avisa y se ignora.
+KernelsBits seleccionar_kernels() {
+    vector<KernelsBits> disponibles = kernels_disponibles();
+
+    string pedido;
+    if (const char* env = getenv("TESTORES_SIMD")) pedido = env;
+    if (pedido.empty()) return disponibles.back();
+
+    const char* niveles[] = {"escalar", "sse42", "avx2", "avx512"};
+    int tope = find(begin(niveles), end(niveles), pedido) - begin(niveles);
+    if (tope == 4) {
+        cerr << "Aviso: TESTORES_SIMD=" << pedido << " no es un nivel conocido (escalar, sse42, avx2, "
+             << "avx512); se usa " << disponibles.back().nombre << ".\n";
+        return disponibles.back();
+    }
+    return disponibles[min<int>(tope, disponibles.size() - 1)];
+}
+
+const KernelsBits& kernels() {
+    static const KernelsBits k = seleccionar_kernels();
+    return k;
+}
+
 
 // Densidad
 double densidad(const Matriz& M) {
@@ -61,6 +756,12 @@ double densidad(const Matriz& M) {
     return double(unos) / total;
 }
 
+double densidad(const MatrizBits& B) {
+    if (B.filas == 0 || B.columnas == 0) return 0;
+    long long unos = kernels().popcount(B.datos.data(), (int)B.datos.size());
+    return double(unos) / (double(B.filas) * B.columnas);
+}
+
 // Subfila
 bool esSubfila(const vector<int>& r, const vector<int>& s) {
     bool menorEstricto = false;
@@ -73,6 +774,7 @@ bool esSubfila(const vector<int>& r, const vector<int>& s) {
 
 // Eliminar filas duplicadas
 Matriz filasUnicas(const Matriz& M) {
+    FasePerfil fase("filasUnicas");
     set<string> visto;
     Matriz out;
 
@@ -90,15 +792,21 @@ Matriz filasUnicas(const Matriz& M) {
 
 // Matriz Basica
 Matriz aMatrizBasica(const Matriz& M) {
+    FasePerfil fase("aMatrizBasica");
     Matriz U = filasUnicas(M);
     int r = U.size();
 
+    MatrizBits UB = empaquetar(U);
+    const KernelsBits& K = kernels();
+
     vector<char> keep(r, 1);
 
     for (int i = 0; i < r; i++)
         for (int j = 0; j < r; j++)
-            if (i != j && esSubfila(U[i], U[j]))
+            if (i != j && K.es_subfila(UB.fila(i), UB.fila(j), UB.palabras)) {
                 keep[i] = 0;
+                break;
+            }
 
     Matriz BM;
     for (int i = 0; i < r; i++)
@@ -112,6 +820,7 @@ int contar_unos(const vector<int>& fila) {
 }
 
 Matriz ordenar_filas_por_unos(const Matriz& M) {
+    FasePerfil fase("ordenamiento");
     Matriz ordenada = M;
     sort(ordenada.begin(), ordenada.end(), [](const vector<int>& a, const vector<int>& b) {
         return contar_unos(a) < contar_unos(b);
@@ -123,54 +832,420 @@ Matriz ordenar_filas_por_unos(const Matriz& M) {
 // ========================== OPERADORES ================================
 // ======================================================================
 
+// ---------------------- Materializacion directa -----------------------
+
+// Reparte las filas [0, n) en bloques contiguos entre los hilos disponibles.
+// Con pocas filas no compensa lanzar hilos y se trabaja en el actual.
+template<class F>
+void en_paralelo(size_t n, F trabajo) {
+    // hardware_concurrency() lee /sys en cada llamada; se consulta una vez
+    static const size_t nucleos = max(1u, thread::hardware_concurrency());
+    size_t hilos = min(nucleos, max<size_t>(1, n / 64));
+    if (hilos <= 1) {
+        trabajo(size_t(0), n);
+        return;
+    }
+    vector<thread> pool;
+    size_t paso = (n + hilos - 1) / hilos;
+    for (size_t ini = 0; ini < n; ini += paso)
+        pool.emplace_back(trabajo, ini, min(n, ini + paso));
+    for (auto& t : pool) t.join();
+}
+
+// Cada operador calcula el tamano final, reserva cada fila una sola vez y
+// la llena con memcpy de las filas de origen, repartiendo las filas entre
+// hilos. Todos los consumidores (menu, lotes, motores) usan Matriz, asi que
+// se construye directamente en denso.
 Matriz phi(const Matriz& A, const Matriz& B) {
     if (A.size() != B.size()) {
         cerr << "Error: phi requiere que A y B tengan el mismo numero de filas.\n";
         return {};
     }
-
-    Matriz resultado;
-    for (size_t i = 0; i < A.size(); ++i) {
-        vector<int> fila = A[i];
-        fila.insert(fila.end(), B[i].begin(), B[i].end());
-        resultado.push_back(fila);
-    }
-    return resultado;
+    if (A.empty()) return {};
+    size_t cA = A[0].size(), cB = B[0].size();
+    Matriz R(A.size());
+    en_paralelo(R.size(), [&](size_t ini, size_t fin) {
+        for (size_t i = ini; i < fin; ++i) {
+            R[i].resize(cA + cB);
+            memcpy(R[i].data(), A[i].data(), cA * sizeof(int));
+            memcpy(R[i].data() + cA, B[i].data(), cB * sizeof(int));
+        }
+    });
+    return R;
 }
 
 Matriz theta(const Matriz& A, const Matriz& B) {
-    Matriz resultado;
-    for (const auto& filaA : A) {
-        for (const auto& filaB : B) {
-            vector<int> fila = filaA;
-            fila.insert(fila.end(), filaB.begin(), filaB.end());
-            resultado.push_back(fila);
+    if (A.empty() || B.empty()) return {};
+    size_t cA = A[0].size(), cB = B[0].size();
+    Matriz R(A.size() * B.size());
+    en_paralelo(R.size(), [&](size_t ini, size_t fin) {
+        for (size_t f = ini; f < fin; ++f) {
+            R[f].resize(cA + cB);
+            memcpy(R[f].data(), A[f / B.size()].data(), cA * sizeof(int));
+            memcpy(R[f].data() + cA, B[f % B.size()].data(), cB * sizeof(int));
         }
-    }
-    return resultado;
+    });
+    return R;
 }
 
 Matriz gamma(const Matriz& A, const Matriz& B) {
-    size_t filasA = A.size(), filasB = B.size();
-    size_t colsA = A[0].size(), colsB = B[0].size();
-    size_t filas = filasA + filasB;
-    size_t cols = colsA + colsB;
+    if (A.empty() || B.empty()) return {};
+    size_t fA = A.size(), cA = A[0].size(), cB = B[0].size();
+    Matriz R(fA + B.size());
+    en_paralelo(R.size(), [&](size_t ini, size_t fin) {
+        for (size_t f = ini; f < fin; ++f) {
+            R[f].resize(cA + cB);   // con ceros; mas rapido que assign(n, 0)
+            if (f < fA) memcpy(R[f].data(), A[f].data(), cA * sizeof(int));
+            else memcpy(R[f].data() + cA, B[f - fA].data(), cB * sizeof(int));
+        }
+    });
+    return R;
+}
 
-    Matriz resultado(filas, vector<int>(cols, 0));
+// phi^n(X) = phi aplicado n veces sobre si mismo: cada fila de X repetida
+// 2^n veces. gamma^n(X): 2^n copias de X en la diagonal de bloques. Ambas
+// se construyen directamente al tamano final, sin las n copias intermedias.
+Matriz phi_n(const Matriz& X, int n) {
+    if (n < 0 || n > 30) {
+        cerr << "Error: n debe estar entre 0 y 30.\n";
+        return {};
+    }
+    if (X.empty()) return X;
+    size_t c = X[0].size(), copias = size_t(1) << n;
+    if (double(X.size()) * c * copias * sizeof(int) > double(size_t(1) << 32)) {
+        cerr << "Error: phi^n produciria una matriz demasiado grande.\n";
+        return {};
+    }
+    Matriz R(X.size());
+    en_paralelo(R.size(), [&](size_t ini, size_t fin) {
+        for (size_t i = ini; i < fin; ++i) {
+            R[i].resize(c * copias);
+            for (size_t k = 0; k < copias; ++k)
+                memcpy(R[i].data() + k * c, X[i].data(), c * sizeof(int));
+        }
+    });
+    return R;
+}
 
-    // Copiar A en la esquina superior izquierda
-    for (size_t i = 0; i < filasA; ++i)
-        for (size_t j = 0; j < colsA; ++j)
-            resultado[i][j] = A[i][j];
+Matriz gamma_n(const Matriz& X, int n) {
+    if (n < 0 || n > 30) {
+        cerr << "Error: n debe estar entre 0 y 30.\n";
+        return {};
+    }
+    if (X.empty()) return X;
+    size_t r = X.size(), c = X[0].size(), copias = size_t(1) << n;
+    if (double(r) * copias * c * copias * sizeof(int) > double(size_t(1) << 32)) {
+        cerr << "Error: gamma^n produciria una matriz demasiado grande.\n";
+        return {};
+    }
+    Matriz R(r * copias);
+    en_paralelo(R.size(), [&](size_t ini, size_t fin) {
+        for (size_t f = ini; f < fin; ++f) {
+            R[f].resize(c * copias);
+            memcpy(R[f].data() + (f / r) * c, X[f % r].data(), c * sizeof(int));
+        }
+    });
+    return R;
+}
 
-    // Copiar B en la esquina inferior derecha
-    for (size_t i = 0; i < filasB; ++i)
-        for (size_t j = 0; j < colsB; ++j)
-            resultado[filasA + i][colsA + j] = B[i][j];
 
-    return resultado;
+// ======================================================================
+// ======================= MATRIZ DE DIFERENCIAS ========================
+// ======================================================================
+
+// Tabla objeto x rasgo con la clase en la ultima columna. Los valores se
+// guardan como codigos enteros por rasgo: dos objetos difieren en un rasgo
+// si sus codigos son distintos.
+struct TablaEtiquetada {
+    int objetos = 0;
+    int rasgos = 0;
+    vector<int> valores;   // objetos x rasgos
+    vector<int> clase;
+};
+
+// Lee un archivo de texto con un objeto por linea; los campos se separan
+// por espacios, tabuladores, comas o punto y coma, y el ultimo es la clase.
+// Las lineas vacias o que empiezan por '#' se ignoran.
+bool leer_tabla_etiquetada(const string& ruta, TablaEtiquetada& T) {
+    ifstream in(ruta);
+    if (!in) {
+        cerr << "Error: no se pudo abrir " << ruta << "\n";
+        return false;
+    }
+
+    vector<map<string, int>> codigos;
+    map<string, int> clases;
+    T = TablaEtiquetada();
+    string linea;
+    int num_linea = 0;
+
+    while (getline(in, linea)) {
+        num_linea++;
+        for (char& ch : linea)
+            if (ch == ',' || ch == ';' || ch == '\t' || ch == '\r') ch = ' ';
+        istringstream ss(linea);
+        vector<string> campos;
+        string campo;
+        while (ss >> campo) campos.push_back(campo);
+        if (campos.empty() || campos[0][0] == '#') continue;
+
+        if (T.objetos == 0) {
+            T.rasgos = campos.size() - 1;
+            codigos.resize(T.rasgos);
+        }
+        if (T.rasgos < 1 || (int)campos.size() != T.rasgos + 1) {
+            cerr << "Error: linea " << num_linea << " con numero de campos distinto.\n";
+            return false;
+        }
+
+        for (int k = 0; k < T.rasgos; ++k)
+            T.valores.push_back(codigos[k].emplace(campos[k], codigos[k].size()).first->second);
+        T.clase.push_back(clases.emplace(campos.back(), clases.size()).first->second);
+        T.objetos++;
+    }
+    return T.objetos > 0;
 }
 
+// Lo que cambio en MB tras insertar una fila: si entro (y con que id) y
+// que ids salieron. Los ids identifican filas de MB mientras siguen en
+// ella; un id liberado puede reutilizarse mas tarde.
+struct CambioMB {
+    bool aceptada = false;
+    int id = -1;
+    vector<int> eliminadas;
+};
+
+// Mantiene una matriz basica mientras llegan filas, con el mismo criterio
+// que aMatrizBasica(): una fila igual o subfila estricta de otra ya
+// guardada se descarta, y las guardadas que son subfilas estrictas de la
+// nueva se eliminan. Con 'minimales' el criterio se invierte y se
+// conservan las filas sin subfilas estrictas: se descarta la fila igual o
+// superfila de otra guardada y salen las superfilas estrictas de la nueva.
+//
+// Las filas se agrupan por numero de unos (una subfila estricta tiene
+// menos unos) y se indexan por columna: por_columna[c] es el bitset de ids
+// con un 1 en c. Asi, "filas que contienen a r" es un AND de columnas de r
+// y "filas contenidas en r" es el complemento del OR de las demas
+// columnas. En cada consulta se usa el indice o se recorren los grupos
+// candidatos, lo que cueste menos.
+struct FiltroDominancia {
+    int columnas;
+    int palabras;
+    bool minimales;
+    int capacidad = 0;
+    vector<uint64_t> filas;                 // capacidad x palabras
+    vector<int> cardinal;                   // -1 = hueco libre
+    vector<int> libres;
+    vector<uint64_t> vivas;                 // bitset de ids ocupados
+    vector<vector<uint64_t>> por_columna;   // columna -> bitset de ids
+    vector<vector<int>> por_cardinal;       // numero de unos -> ids
+    vector<int> pos_en_grupo;
+    vector<int> halladas;
+    vector<uint64_t> acc;
+    int cantidad = 0;
+    long long aceptadas = 0, rechazadas = 0, desalojadas = 0;
+
+    explicit FiltroDominancia(int columnas, bool minimales = false)
+        : columnas(columnas), palabras(palabras_para(columnas)), minimales(minimales),
+          por_columna(columnas), por_cardinal(columnas + 1) {}
+
+    const uint64_t* fila(int id) const { return filas.data() + (size_t)id * palabras; }
+
+    CambioMB insertar(const uint64_t* r) {
+        CambioMB cambio;
+        int pc = kernels().popcount(r, palabras);
+
+        // 1) Alguna fila guardada domina a r (o es igual): se rechaza
+        if (minimales) buscar(r, pc, false, 0, pc, true, halladas);
+        else buscar(r, pc, true, pc, columnas, true, halladas);
+        if (!halladas.empty()) {
+            rechazadas++;
+            return cambio;
+        }
+
+        // 2) Filas guardadas dominadas estrictamente por r: salen de MB
+        if (minimales) buscar(r, pc, true, pc + 1, columnas, false, cambio.eliminadas);
+        else buscar(r, pc, false, 0, pc - 1, false, cambio.eliminadas);
+        for (int id : cambio.eliminadas) quitar(id);
+        desalojadas += cambio.eliminadas.size();
+
+        cambio.aceptada = true;
+        cambio.id = guardar(r, pc);
+        aceptadas++;
+        return cambio;
+    }
+
+    MatrizBits matriz() const {
+        MatrizBits B;
+        B.filas = cantidad;
+        B.columnas = columnas;
+        B.palabras = palabras;
+        for (int id = 0; id < capacidad; ++id)
+            if (cardinal[id] >= 0) B.datos.insert(B.datos.end(), fila(id), fila(id) + palabras);
+        return B;
+    }
+
+private:
+    // r no tiene ningun 1 fuera de s
+    static bool contenida(const uint64_t* r, const uint64_t* s, int n) {
+        for (int i = 0; i < n; ++i)
+            if (r[i] & ~s[i]) return false;
+        return true;
+    }
+
+    // Deja en 'ids' las filas guardadas con entre 'desde' y 'hasta' unos que
+    // contienen a r ('arriba') o que estan contenidas en r; pc es el numero
+    // de unos de r. Con 'primera' basta con una.
+    void buscar(const uint64_t* r, int pc, bool arriba, int desde, int hasta, bool primera, vector<int>& ids) {
+        ids.clear();
+        desde = max(desde, 0);
+        hasta = min(hasta, columnas);
+        long long en_grupos = 0;
+        for (int k = desde; k <= hasta; ++k) en_grupos += por_cardinal[k].size();
+        if (en_grupos == 0) return;
+
+        int bw = capacidad / 64;
+        long long costo_indice = (long long)(arriba ? pc : columnas - pc) * bw;
+        if (en_grupos * palabras <= costo_indice) {
+            for (int k = desde; k <= hasta; ++k)
+                for (int id : por_cardinal[k])
+                    if (arriba ? contenida(r, fila(id), palabras) : contenida(fila(id), r, palabras)) {
+                        ids.push_back(id);
+                        if (primera) return;
+                    }
+            return;
+        }
+
+        // Arriba: AND de las columnas de r. Abajo: vivas sin el OR de las
+        // columnas que r no tiene.
+        if (arriba) {
+            acc = vivas;
+            for (int w = 0; w < palabras; ++w)
+                for (uint64_t x = r[w]; x; x &= x - 1) {
+                    const uint64_t* col = por_columna[w * 64 + ctz64(x)].data();
+                    for (int b = 0; b < bw; ++b) acc[b] &= col[b];
+                }
+        } else {
+            acc.assign(bw, 0);
+            for (int w = 0; w < palabras; ++w) {
+                uint64_t resto = ~r[w] & (w == palabras - 1 ? mascara_ultima(columnas) : ~0ULL);
+                for (; resto; resto &= resto - 1) {
+                    const uint64_t* col = por_columna[w * 64 + ctz64(resto)].data();
+                    for (int b = 0; b < bw; ++b) acc[b] |= col[b];
+                }
+            }
+            for (int b = 0; b < bw; ++b) acc[b] = vivas[b] & ~acc[b];
+        }
+        for (int b = 0; b < bw; ++b)
+            for (uint64_t x = acc[b]; x; x &= x - 1) {
+                int id = b * 64 + ctz64(x);
+                if (cardinal[id] < desde || cardinal[id] > hasta) continue;
+                ids.push_back(id);
+                if (primera) return;
+            }
+    }
+
+    int guardar(const uint64_t* r, int pc) {
+        if (libres.empty()) crecer();
+        int id = libres.back();
+        libres.pop_back();
+        copy(r, r + palabras, filas.begin() + (size_t)id * palabras);
+        cardinal[id] = pc;
+        pos_en_grupo[id] = por_cardinal[pc].size();
+        por_cardinal[pc].push_back(id);
+        vivas[id >> 6] |= 1ULL << (id & 63);
+        for (int w = 0; w < palabras; ++w)
+            for (uint64_t x = r[w]; x; x &= x - 1)
+                por_columna[w * 64 + ctz64(x)][id >> 6] |= 1ULL << (id & 63);
+        cantidad++;
+        return id;
+    }
+
+    void quitar(int id) {
+        const uint64_t* r = fila(id);
+        for (int w = 0; w < palabras; ++w)
+            for (uint64_t x = r[w]; x; x &= x - 1)
+                por_columna[w * 64 + ctz64(x)][id >> 6] &= ~(1ULL << (id & 63));
+        vivas[id >> 6] &= ~(1ULL << (id & 63));
+
+        vector<int>& g = por_cardinal[cardinal[id]];
+        int ultimo = g.back();
+        g[pos_en_grupo[id]] = ultimo;
+        pos_en_grupo[ultimo] = pos_en_grupo[id];
+        g.pop_back();
+
+        cardinal[id] = -1;
+        libres.push_back(id);
+        cantidad--;
+    }
+
+    // Duplica la capacidad (siempre multiplo de 64 ids)
+    void crecer() {
+        int nueva = max(64, capacidad * 2);
+        filas.resize((size_t)nueva * palabras, 0);
+        cardinal.resize(nueva, -1);
+        pos_en_grupo.resize(nueva, 0);
+        vivas.resize(nueva / 64, 0);
+        for (auto& c : por_columna) c.resize(nueva / 64, 0);
+        for (int id = nueva - 1; id >= capacidad; --id) libres.push_back(id);
+        capacidad = nueva;
+    }
+};
+
+// Compara en paralelo todos los pares de objetos de clases distintas. Cada
+// fila de diferencias se empaqueta y entra directamente en un filtro por
+// hilo, asi que la matriz de diferencias completa nunca existe en memoria.
+// Al final los filtros de cada hilo se unen en uno solo. Los pares de
+// objetos identicos de clases distintas (filas de ceros, que el filtro
+// descarta en cuanto hay otra fila) se cuentan en 'identicos'.
+MatrizBits matriz_basica_desde_tabla(const TablaEtiquetada& T, long long* pares = nullptr,
+                                     long long* identicos = nullptr) {
+    int hilos = max(1u, thread::hardware_concurrency());
+    hilos = min(hilos, max(1, T.objetos / 32));
+
+    vector<FiltroDominancia> locales(hilos, FiltroDominancia(T.rasgos));
+    vector<long long> comparados(hilos, 0), iguales(hilos, 0);
+
+    auto trabajo = [&](int h) {
+        vector<uint64_t> fila(palabras_para(T.rasgos));
+        // Objetos intercalados entre hilos para repartir el triangulo de pares
+        for (int i = h; i < T.objetos; i += hilos) {
+            const int* a = T.valores.data() + (size_t)i * T.rasgos;
+            for (int j = i + 1; j < T.objetos; ++j) {
+                if (T.clase[i] == T.clase[j]) continue;
+                const int* b = T.valores.data() + (size_t)j * T.rasgos;
+                fill(fila.begin(), fila.end(), 0);
+                bool distintos = false;
+                for (int k = 0; k < T.rasgos; ++k)
+                    if (a[k] != b[k]) {
+                        fila[k >> 6] |= 1ULL << (k & 63);
+                        distintos = true;
+                    }
+                if (!distintos) iguales[h]++;
+                locales[h].insertar(fila.data());
+                comparados[h]++;
+            }
+        }
+    };
+
+    if (hilos == 1) {
+        trabajo(0);
+    } else {
+        vector<thread> pool;
+        for (int h = 0; h < hilos; ++h) pool.emplace_back(trabajo, h);
+        for (auto& t : pool) t.join();
+    }
+
+    FiltroDominancia total(T.rasgos);
+    for (auto& f : locales) {
+        MatrizBits parcial = f.matriz();
+        for (int i = 0; i < parcial.filas; ++i) total.insertar(parcial.fila(i));
+    }
+
+    if (pares) *pares = accumulate(comparados.begin(), comparados.end(), 0LL);
+    if (identicos) *identicos = accumulate(iguales.begin(), iguales.end(), 0LL);
+    return total.matriz();
+}
 
 // ======================================================================
 // ============================== YYC ==================================
@@ -183,6 +1258,10 @@ bool tiene_uno_en_fila(const vector<int>& fila, const Conjunto& conjunto) {
     return false;
 }
 
+bool tiene_uno_en_fila(const uint64_t* fila, const uint64_t* conjunto, int palabras) {
+    return kernels().interseca(fila, conjunto, palabras);
+}
+
 bool cumple_criterios(const Matriz& MB, const Conjunto& C, int hastaFila) {
     int columnas = C.size();
     int cuenta_filas = 0;
@@ -218,6 +1297,7 @@ vector<Conjunto> YYC(const Matriz& MB) {
             activos.push_back({j});
 
     for (int f = 1; f < filas; f++) {
+        FasePerfil fase("YYC fila", f + 1);
         vector<Conjunto> nuevos;
         const vector<int>& fila = MB[f];
 
@@ -279,18 +1359,20 @@ vector<vector<int>> BT(const Matriz& MB) {
 
     auto inicio = chrono::high_resolution_clock::now();
 
+    // Copia empaquetada de MB para las pruebas de cobertura fila a fila
+    MatrizBits MBb = empaquetar(MB);
+    const KernelsBits& ker = kernels();
+    vector<uint64_t> candb(MBb.palabras);
+
+    auto cargar_candidato = [&](const vector<int>& nuplo) {
+        fill(candb.begin(), candb.end(), 0);
+        for (int j = 0; j < COLS; j++)
+            if (nuplo[j] == 1) candb[j >> 6] |= 1ULL << (j & 63);
+    };
+
     auto es_testor = [&](const vector<int>& nuplo) {
-        for (int i = 0; i < ROWS; i++) {
-            bool tiene_uno = false;
-            for (int j = 0; j < COLS; j++) {
-                if (nuplo[j] == 1 && MB[i][j] == 1) {
-                    tiene_uno = true;
-                    break;
-                }
-            }
-            if (!tiene_uno) return false;
-        }
-        return true;
+        cargar_candidato(nuplo);
+        return ker.cubre_filas(MBb.datos.data(), ROWS, MBb.palabras, candb.data());
     };
 
     auto es_subtestor = [&](const vector<int>& cand) {
@@ -315,16 +1397,10 @@ vector<vector<int>> BT(const Matriz& MB) {
 
     auto encontrar_K = [&](const vector<int>& nuplo) {
         vector<int> filas_ceros;
-        for (int i = 0; i < ROWS; i++) {
-            bool fila_c = true;
-            for (int j = 0; j < COLS; j++) {
-                if (nuplo[j] == 1 && MB[i][j] == 1) {
-                    fila_c = false;
-                    break;
-                }
-            }
-            if (fila_c) filas_ceros.push_back(i);
-        }
+        cargar_candidato(nuplo);
+        for (int i = 0; i < ROWS; i++)
+            if (!ker.interseca(MBb.fila(i), candb.data(), MBb.palabras))
+                filas_ceros.push_back(i);
 
         int K = COLS + 1;
         for (int f : filas_ceros) {
@@ -355,6 +1431,7 @@ vector<vector<int>> BT(const Matriz& MB) {
     vector<int> b(COLS, 0);
     b[COLS - 1] = 1;
 
+    FasePerfil fase("BT busqueda");
     while (true) {
 
         long long val = 0;
@@ -400,6 +1477,7 @@ vector<vector<int>> BT(const Matriz& MB) {
             }
         }
     }
+    fase.terminar();
 
     auto fin = chrono::high_resolution_clock::now();
     double ms = chrono::duration<double, milli>(fin - inicio).count();
@@ -410,18 +1488,2891 @@ vector<vector<int>> BT(const Matriz& MB) {
     return testores;
 }
 
-int main() {
-    Matriz M, MB, ultimaGeneradaPotenciada;
-    int op;
+// ======================================================================
+// ================= MOTORES EMPAQUETADOS DE ANCHO FIJO =================
+// ======================================================================
 
-    while (true) {
-        cout << "\n================ MENU PRINCIPAL ================\n";
+// Conjunto de columnas empaquetado (columna j en el bit j % 64 de la
+// palabra j / 64). Es el formato comun de resultados de los motores.
+typedef vector<uint64_t> ConjuntoBits;
+
+vector<int> bits_a_vector_binario(const ConjuntoBits& C, int columnas) {
+    vector<int> v(columnas, 0);
+    for (int j = 0; j < columnas; ++j)
+        v[j] = (C[j >> 6] >> (j & 63)) & 1;
+    return v;
+}
+
+void imprimir_testores(const vector<ConjuntoBits>& testores, int columnas) {
+    FasePerfil fase("salida");
+    for (auto& C : testores) {
+        for (int b : bits_a_vector_binario(C, columnas)) cout << b << " ";
+        cout << "\n";
+    }
+}
+
+// Tipo de candidato para N palabras: un std::array cuando N se conoce en
+// compilacion (los bucles se desenrollan y el candidato vive en registros)
+// y un vector cuando N == 0 (ancho dinamico).
+template<int N> struct Palabras { typedef array<uint64_t, N> Tipo; };
+template<> struct Palabras<0> { typedef vector<uint64_t> Tipo; };
+
+template<int N>
+struct MotorBits {
+    typedef typename Palabras<N>::Tipo Cand;
+
+    int filas, columnas, nw;
+    vector<Cand> M;            // filas de MB con exactamente nw palabras
+    MatrizBits F;              // MB empaquetada por filas, para es_testor()
+    MatrizBits T;              // transpuesta: filas con un 1 en cada columna
+    vector<int> ultima_pos;    // posicion (base 1) del ultimo 1 de cada fila, -1 si es nula
+
+    explicit MotorBits(const Matriz& MB)
+        : filas(MB.size()), columnas(MB[0].size()),
+          nw(N ? N : palabras_para(MB[0].size())), M(MB.size(), vacio()),
+          F(empaquetar(MB)), T(transponer(F)), ultima_pos(MB.size(), -1) {
+        for (int i = 0; i < filas; ++i)
+            for (int j = 0; j < columnas; ++j)
+                if (MB[i][j]) {
+                    poner(M[i], j);
+                    ultima_pos[i] = j + 1;
+                }
+    }
+
+    // Motor vacio al que se le agregan filas con agregar_fila()
+    explicit MotorBits(int columnas)
+        : filas(0), columnas(columnas), nw(N ? N : palabras_para(columnas)) {
+        F.columnas = columnas;
+        F.palabras = palabras_para(columnas);
+        T.filas = columnas;
+        T.columnas = 0;
+        T.palabras = 1;
+        T.datos.assign(columnas, 0);
+    }
+
+    // Agrega una fila al final; la transpuesta duplica su capacidad cuando
+    // se llena, asi que el costo amortizado es el de marcar sus unos.
+    void agregar_fila(const Cand& r) {
+        if (filas == T.palabras * 64) {
+            int nuevas = T.palabras * 2;
+            vector<uint64_t> datos((size_t)columnas * nuevas, 0);
+            for (int c = 0; c < columnas; ++c)
+                copy(T.fila(c), T.fila(c) + T.palabras, datos.begin() + (size_t)c * nuevas);
+            T.palabras = nuevas;
+            T.datos.swap(datos);
+        }
+        int ultima = -1;
+        for (int w = 0; w < ancho(); ++w)
+            for (uint64_t x = r[w]; x; x &= x - 1) {
+                int c = w * 64 + ctz64(x);
+                T.datos[(size_t)c * T.palabras + (filas >> 6)] |= 1ULL << (filas & 63);
+                ultima = c + 1;
+            }
+        M.push_back(r);
+        F.datos.insert(F.datos.end(), r.begin(), r.begin() + F.palabras);
+        F.filas++;
+        ultima_pos.push_back(ultima);
+        T.columnas = ++filas;
+    }
+
+    int ancho() const { return N ? N : nw; }
+
+    Cand vacio() const {
+        Cand c{};
+        if constexpr (N == 0) c.assign(nw, 0);
+        return c;
+    }
+
+    static void poner(Cand& c, int j) { c[j >> 6] |= 1ULL << (j & 63); }
+    static void quitar(Cand& c, int j) { c[j >> 6] &= ~(1ULL << (j & 63)); }
+    static bool tiene(const Cand& c, int j) { return (c[j >> 6] >> (j & 63)) & 1; }
+
+    bool interseca(const Cand& a, const Cand& b) const {
+        uint64_t x = 0;
+        for (int w = 0; w < ancho(); ++w) x |= a[w] & b[w];
+        return x != 0;
+    }
+
+    // a esta contenido en b
+    bool contenido(const Cand& a, const Cand& b) const {
+        uint64_t x = 0;
+        for (int w = 0; w < ancho(); ++w) x |= a[w] & ~b[w];
+        return x == 0;
+    }
+
+    // Orden de BT: a < b leyendo la columna 0 como bit mas significativo
+    bool menor_lex(const Cand& a, const Cand& b) const {
+        for (int w = 0; w < ancho(); ++w)
+            if (uint64_t x = a[w] ^ b[w]) return (b[w] >> ctz64(x)) & 1;
+        return false;
+    }
+
+    int popcount(const Cand& a) const {
+        int c = 0;
+        for (int w = 0; w < ancho(); ++w) c += popcount64(a[w]);
+        return c;
+    }
+
+    // Filas (hasta 'hastaFila' inclusive) cubiertas por alguna columna de C
+    // y, en 'dos', las cubiertas por al menos dos: un OR de columnas de T.
+    void cubrir(const Cand& C, int hastaFila, vector<uint64_t>& uno, vector<uint64_t>& dos) const {
+        int rw = palabras_para(hastaFila + 1);
+        uno.assign(rw, 0);
+        dos.assign(rw, 0);
+        for (int w = 0; w < ancho(); ++w) {
+            uint64_t x = C[w];
+            while (x) {
+                const uint64_t* col = T.fila(w * 64 + ctz64(x));
+                for (int r = 0; r < rw; ++r) {
+                    dos[r] |= uno[r] & col[r];
+                    uno[r] |= col[r];
+                }
+                x &= x - 1;
+            }
+        }
+        uint64_t ultima = mascara_ultima(hastaFila + 1);
+        uno[rw - 1] &= ultima;
+        dos[rw - 1] &= ultima;
+    }
+
+    // Solo las filas cubiertas (sin 'dos'), para es_testor()
+    void cubrir(const Cand& C, int hastaFila, vector<uint64_t>& uno) const {
+        int rw = palabras_para(hastaFila + 1);
+        uno.assign(rw, 0);
+        for (int w = 0; w < ancho(); ++w)
+            for (uint64_t x = C[w]; x; x &= x - 1) {
+                const uint64_t* col = T.fila(w * 64 + ctz64(x));
+                for (int r = 0; r < rw; ++r) uno[r] |= col[r];
+            }
+        uno[rw - 1] &= mascara_ultima(hastaFila + 1);
+    }
+
+    // Mismo criterio que cumple_criterios(): al menos |ext| filas con un
+    // solo 1 en ext y cada columna de ext con algun 1 hasta 'hastaFila'.
+    // Se resuelve sobre la transpuesta, palabra a palabra de filas.
+    bool cumple_criterios(const Cand& ext, int hastaFila, vector<uint64_t>& uno, vector<uint64_t>& dos) const {
+        int rw = palabras_para(hastaFila + 1);
+        uint64_t ultima = mascara_ultima(hastaFila + 1);
+        for (int w = 0; w < ancho(); ++w)
+            for (uint64_t x = ext[w]; x; x &= x - 1) {
+                const uint64_t* col = T.fila(w * 64 + ctz64(x));
+                uint64_t hay = 0;
+                for (int r = 0; r < rw - 1; ++r) hay |= col[r];
+                if (!(hay | (col[rw - 1] & ultima))) return false;
+            }
+
+        cubrir(ext, hastaFila, uno, dos);
+        int cuenta_filas = 0;
+        for (int r = 0; r < rw; ++r) cuenta_filas += popcount64(uno[r] & ~dos[r]);
+        return cuenta_filas >= popcount(ext);
+    }
+
+    // BT: b cubre todas las filas. Si no, deja en 'cubiertas' las filas
+    // cubiertas, que encontrar_K() usa despues sin recalcularlas.
+    // Con mas de 64 columnas la transpuesta cuesta |b| pasadas por las
+    // palabras de filas; si eso pasa de unas dos veces el numero de filas
+    // es mas barato recorrer las filas con cubre_filas(), que corta en la
+    // primera que b no cubre, y dejar la transpuesta para encontrar_K().
+    bool es_testor(const Cand& b, vector<uint64_t>& cubiertas) const {
+        if (F.palabras > 1 && filas < 2 * popcount(b) * palabras_para(filas) &&
+            kernels().cubre_filas(F.datos.data(), filas, F.palabras, b.data()))
+            return true;
+        cubrir(b, filas - 1, cubiertas);
+        int rw = cubiertas.size();
+        for (int r = 0; r < rw - 1; r++)
+            if (~cubiertas[r]) return false;
+        return cubiertas[rw - 1] == mascara_ultima(filas);
+    }
+
+    // Menor ultima_pos entre las filas que b no cubre; columnas + 1 si no hay
+    int encontrar_K(const vector<uint64_t>& cubiertas) const {
+        int K = columnas + 1;
+        int rw = cubiertas.size();
+        for (int r = 0; r < rw; r++) {
+            uint64_t libres = ~cubiertas[r] & (r == rw - 1 ? mascara_ultima(filas) : ~0ULL);
+            for (; libres; libres &= libres - 1) {
+                int i = r * 64 + ctz64(libres);
+                if (ultima_pos[i] != -1 && ultima_pos[i] < K)
+                    K = ultima_pos[i];
+            }
+        }
+        return K;
+    }
+
+    ConjuntoBits exportar(const Cand& c) const {
+        return ConjuntoBits(c.begin(), c.begin() + palabras_para(columnas));
+    }
+
+    Cand importar(const ConjuntoBits& c) const {
+        Cand r = vacio();
+        copy(c.begin(), c.end(), r.begin());
+        return r;
+    }
+};
+
+template<int N>
+struct HashCand {
+    size_t operator()(const typename Palabras<N>::Tipo& c) const {
+        uint64_t h = 1469598103934665603ULL;
+        for (uint64_t w : c) {
+            h ^= w;
+            h *= 1099511628211ULL;
+            h ^= h >> 29;
+        }
+        return size_t(h);
+    }
+};
+
+// ---------------------- Presupuesto y checkpoints ---------------------
+
+// Limites de una busqueda larga. Con presupuesto_ms o presupuesto_nodos
+// distintos de 0 la busqueda se detiene limpiamente al agotarlos; con
+// 'checkpoint' no vacio se guarda el estado cada 'intervalo_ms' y al parar.
+struct OpcionesBusqueda {
+    double presupuesto_ms = 0;
+    long long presupuesto_nodos = 0;
+    string checkpoint;
+    double intervalo_ms = 30000;
+    ConjuntoBits limite;   // BT: parar al llegar a este n-uplo (vacio = sin limite)
+    bool silencioso = false;   // sin tiempos por cout (tareas de un lote)
+};
+
+// Como termino una busqueda: 'cobertura' es la fraccion del espacio ya
+// recorrida (filas procesadas en YYC, posicion del cursor en BT).
+struct InfoBusqueda {
+    bool completa = true;
+    double cobertura = 1.0;
+    long long nodos = 0;
+    double ms = 0;
+};
+
+// Estado reanudable. YYC: 'fila' es la fila en curso, 'conjuntos' los
+// activos de la fila anterior, 'indice' cuantos de ellos ya se extendieron
+// en 'fila' y 'parciales' lo que produjeron; con indice 0 la fila esta sin
+// empezar. BT: 'cursor' es el siguiente n-uplo a evaluar y 'conjuntos' los
+// testores hallados. MB es la matriz ya ordenada.
+struct Checkpoint {
+    int alg = 1;
+    Matriz MB;
+    uint32_t fila = 0;
+    uint64_t indice = 0;
+    ConjuntoBits cursor;
+    vector<ConjuntoBits> conjuntos;
+    vector<ConjuntoBits> parciales;
+    long long nodos = 0;
+    double ms = 0;
+};
+
+// La version 1 no guardaba la posicion dentro de la fila; se sigue leyendo.
+const char MAGIA_CHECKPOINT_V1[8] = {'T', 'T', 'C', 'H', 'K', 'P', 'T', '1'};
+const char MAGIA_CHECKPOINT[8] = {'T', 'T', 'C', 'H', 'K', 'P', 'T', '2'};
+
+// Formato binario de un Checkpoint; es el mismo que viaja a los procesos
+// trabajadores en la busqueda distribuida.
+string serializar_checkpoint(const Checkpoint& c) {
+    MatrizBits B = empaquetar(c.MB);
+    uint32_t cab[5] = {uint32_t(c.alg), uint32_t(B.filas), uint32_t(B.columnas), c.fila,
+                       uint32_t(c.cursor.size())};
+    uint64_t cantidad = c.conjuntos.size();
+    uint64_t pos[2] = {c.indice, c.parciales.size()};
+
+    vector<uint64_t> cuerpo(B.datos);
+    cuerpo.insert(cuerpo.end(), c.cursor.begin(), c.cursor.end());
+    for (auto& s : c.conjuntos) cuerpo.insert(cuerpo.end(), s.begin(), s.end());
+    for (auto& s : c.parciales) cuerpo.insert(cuerpo.end(), s.begin(), s.end());
+    uint64_t suma = fnv1a(cuerpo.data(), cuerpo.size() * sizeof(uint64_t),
+                          fnv1a(pos, sizeof(pos), fnv1a(cab, sizeof(cab))));
+
+    string out(MAGIA_CHECKPOINT, 8);
+    out.append((const char*)cab, sizeof(cab));
+    out.append((const char*)&cantidad, sizeof(cantidad));
+    out.append((const char*)&c.nodos, sizeof(c.nodos));
+    out.append((const char*)&c.ms, sizeof(c.ms));
+    out.append((const char*)pos, sizeof(pos));
+    out.append((const char*)cuerpo.data(), cuerpo.size() * sizeof(uint64_t));
+    out.append((const char*)&suma, sizeof(suma));
+    return out;
+}
+
+bool deserializar_checkpoint(const string& in, Checkpoint& c) {
+    bool v1 = in.size() >= 8 && memcmp(in.data(), MAGIA_CHECKPOINT_V1, 8) == 0;
+    size_t fijo = 8 + 5 * sizeof(uint32_t) + sizeof(uint64_t) + sizeof(long long) + sizeof(double);
+    if (!v1) fijo += 2 * sizeof(uint64_t);
+    if (in.size() < fijo + sizeof(uint64_t) || (!v1 && memcmp(in.data(), MAGIA_CHECKPOINT, 8) != 0))
+        return false;
+
+    uint32_t cab[5];
+    uint64_t cantidad, suma;
+    uint64_t pos[2] = {0, 0};
+    const char* p = in.data() + 8;
+    memcpy(cab, p, sizeof(cab)); p += sizeof(cab);
+    memcpy(&cantidad, p, sizeof(cantidad)); p += sizeof(cantidad);
+    memcpy(&c.nodos, p, sizeof(c.nodos)); p += sizeof(c.nodos);
+    memcpy(&c.ms, p, sizeof(c.ms)); p += sizeof(c.ms);
+    if (!v1) {
+        memcpy(pos, p, sizeof(pos));
+        p += sizeof(pos);
+    }
+
+    // Los tamanos leidos se comprueban contra el tamano real por division
+    int filas = cab[1], columnas = cab[2], nw = palabras_para(columnas);
+    if (cab[4] != 0 && int(cab[4]) != nw) return false;
+    size_t disponibles = (in.size() - fijo) / sizeof(uint64_t) - 1;
+    size_t base = (size_t)filas * nw + cab[4];
+    if (nw == 0 || (in.size() - fijo) % sizeof(uint64_t) != 0 || base > disponibles ||
+        (disponibles - base) % nw != 0 || cantidad > (disponibles - base) / nw ||
+        pos[1] != (disponibles - base) / nw - cantidad || pos[0] > cantidad)
+        return false;
+    size_t palabras = disponibles;
+
+    vector<uint64_t> cuerpo(palabras);
+    memcpy(cuerpo.data(), p, palabras * sizeof(uint64_t)); p += palabras * sizeof(uint64_t);
+    memcpy(&suma, p, sizeof(suma));
+    uint64_t semilla = v1 ? fnv1a(cab, sizeof(cab)) : fnv1a(pos, sizeof(pos), fnv1a(cab, sizeof(cab)));
+    if (suma != fnv1a(cuerpo.data(), cuerpo.size() * sizeof(uint64_t), semilla))
+        return false;
+
+    MatrizBits B;
+    B.filas = filas;
+    B.columnas = columnas;
+    B.palabras = nw;
+    B.datos.assign(cuerpo.begin(), cuerpo.begin() + (size_t)filas * nw);
+    c.alg = cab[0];
+    c.MB = desempaquetar(B);
+    c.fila = cab[3];
+    auto q = cuerpo.begin() + (size_t)filas * nw;
+    c.cursor.assign(q, q + cab[4]);
+    q += cab[4];
+    c.conjuntos.assign(cantidad, ConjuntoBits(nw));
+    for (auto& s : c.conjuntos) {
+        copy(q, q + nw, s.begin());
+        q += nw;
+    }
+    c.indice = pos[0];
+    c.parciales.assign(pos[1], ConjuntoBits(nw));
+    for (auto& s : c.parciales) {
+        copy(q, q + nw, s.begin());
+        q += nw;
+    }
+    return true;
+}
+
+// Se escribe a un temporal y se renombra: un corte nunca deja el
+// checkpoint anterior a medias.
+bool guardar_checkpoint(const string& ruta, const Checkpoint& c) {
+    string datos = serializar_checkpoint(c);
+    string tmp = ruta + ".tmp";
+    {
+        ofstream out(tmp, ios::binary | ios::trunc);
+        if (!out || !out.write(datos.data(), datos.size())) return false;
+    }
+    error_code ec;
+    filesystem::rename(tmp, ruta, ec);
+    return !ec;
+}
+
+bool cargar_checkpoint(const string& ruta, Checkpoint& c) {
+    ifstream in(ruta, ios::binary);
+    if (!in) return false;
+    string datos((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    return deserializar_checkpoint(datos, c);
+}
+
+// Lleva la cuenta de nodos y tiempo de una busqueda y decide cuando parar
+// y cuando toca guardar un checkpoint.
+struct ControlBusqueda {
+    const OpcionesBusqueda& op;
+    chrono::high_resolution_clock::time_point inicio = chrono::high_resolution_clock::now();
+    double ms_previos;
+    double ultimo_checkpoint = 0;
+    long long nodos;
+    long long nodos_previos;
+
+    ControlBusqueda(const OpcionesBusqueda& op, const Checkpoint* desde)
+        : op(op), ms_previos(desde ? desde->ms : 0), nodos(desde ? desde->nodos : 0),
+          nodos_previos(nodos) {}
+
+    double ms() const {
+        return chrono::duration<double, milli>(chrono::high_resolution_clock::now() - inicio).count();
+    }
+
+    // Se llama una vez por nodo; el reloj solo se consulta cada 1024 nodos.
+    // Los presupuestos valen para esta sesion, no para el total acumulado.
+    bool agotado() {
+        ++nodos;
+        if (op.presupuesto_nodos > 0 && nodos - nodos_previos > op.presupuesto_nodos) return true;
+        return op.presupuesto_ms > 0 && (nodos & 1023) == 0 && ms() >= op.presupuesto_ms;
+    }
+
+    bool toca_checkpoint() {
+        if (op.checkpoint.empty()) return false;
+        double t = ms();
+        if (t - ultimo_checkpoint < op.intervalo_ms) return false;
+        ultimo_checkpoint = t;
+        return true;
+    }
+
+    void cerrar(InfoBusqueda* info, bool completa, double cobertura) const {
+        if (!info) return;
+        info->completa = completa;
+        info->cobertura = cobertura;
+        info->nodos = nodos;
+        info->ms = ms_previos + ms();
+    }
+};
+
+// ------------------------------- YYC ----------------------------------
+
+template<int N>
+vector<ConjuntoBits> YYC_bits(const Matriz& MB, const OpcionesBusqueda& op = OpcionesBusqueda(),
+                              InfoBusqueda* info = nullptr, const Checkpoint* desde = nullptr) {
+    typedef typename MotorBits<N>::Cand Cand;
+    MotorBits<N> E(MB);
+    int filas = E.filas;
+    int columnas = E.columnas;
+
+    vector<uint64_t> uno, dos;
+    vector<Cand> activos, nuevos;
+    int f = 1;
+    size_t k = 0;
+
+    auto inicio = chrono::high_resolution_clock::now();
+    ControlBusqueda ctl(op, desde);
+
+    if (desde) {
+        f = desde->fila;
+        k = desde->indice;
+        for (auto& c : desde->conjuntos) activos.push_back(E.importar(c));
+        for (auto& c : desde->parciales) nuevos.push_back(E.importar(c));
+    } else {
+        for (int j = 0; j < columnas; j++)
+            if (MotorBits<N>::tiene(E.M[0], j)) {
+                Cand c = E.vacio();
+                MotorBits<N>::poner(c, j);
+                activos.push_back(c);
+            }
+    }
+
+    // Estado reanudable: la fila en curso, los activos de la anterior y,
+    // si la fila quedo a medias, cuantos se extendieron y lo que produjeron
+    auto checkpoint = [&](int fila, size_t indice) {
+        Checkpoint c;
+        c.alg = 1;
+        c.MB = MB;
+        c.fila = fila;
+        c.indice = indice;
+        for (auto& a : activos) c.conjuntos.push_back(E.exportar(a));
+        if (indice > 0)
+            for (auto& a : nuevos) c.parciales.push_back(E.exportar(a));
+        c.nodos = ctl.nodos;
+        c.ms = ctl.ms_previos + ctl.ms();
+        guardar_checkpoint(op.checkpoint, c);
+    };
+
+    vector<int> columnasActivas;
+    unordered_set<Cand, HashCand<N>> vistos;
+    bool agotado = false;
+
+    for (; f < filas; f++) {
+        FasePerfil fase("YYC fila", f + 1);
+        const Cand& fila = E.M[f];
+        // Solo la fila reanudada empieza con trabajo hecho
+        if (k == 0) nuevos.clear();
+
+        columnasActivas.clear();
+        for (int j = 0; j < columnas; j++)
+            if (MotorBits<N>::tiene(fila, j))
+                columnasActivas.push_back(j);
+
+        for (; k < activos.size(); k++) {
+            if (ctl.agotado()) {
+                agotado = true;
+                break;
+            }
+            const Cand& C = activos[k];
+            if (E.interseca(fila, C)) {
+                nuevos.push_back(C);
+            } else {
+                for (int col : columnasActivas) {
+                    Cand ext = C;
+                    MotorBits<N>::poner(ext, col);
+                    if (E.cumple_criterios(ext, f, uno, dos))
+                        nuevos.push_back(ext);
+                }
+            }
+        }
+
+        // Una fila a medias no se devuelve, pero el checkpoint guarda por
+        // donde iba: cada sesion avanza aunque una fila cueste mas que el
+        // presupuesto.
+        if (agotado) break;
+        k = 0;
+
+        // Quitar repetidos conservando la primera aparicion
+        vistos.clear();
+        activos.clear();
+        for (auto& c : nuevos)
+            if (vistos.insert(c).second)
+                activos.push_back(c);
+
+        auto ahora = chrono::high_resolution_clock::now();
+        double ms = chrono::duration<double, milli>(ahora - inicio).count();
+
+        if (!op.silencioso)
+            cout << "\n Tiempo acumulado hasta fila " << f + 1 << ": "
+                 << fixed << setprecision(3) << ms << " ms\n";
+
+        if (f + 1 < filas && ctl.toca_checkpoint()) checkpoint(f + 1, 0);
+    }
+
+    if (agotado && !op.checkpoint.empty()) checkpoint(f, k);
+    ctl.cerrar(info, !agotado, agotado ? (f + double(k) / activos.size()) / filas : 1.0);
+
+    vector<ConjuntoBits> resultado;
+    resultado.reserve(activos.size());
+    for (auto& c : activos) resultado.push_back(E.exportar(c));
+    return resultado;
+}
+
+// -------------------------------- BT ----------------------------------
+
+// Mismo recorrido que BT(): el n-uplo se lee como un numero binario con la
+// columna 0 como bit mas significativo, asi que sumar 1 equivale a poner la
+// ultima columna en 0 de la derecha y limpiar las siguientes.
+template<int N>
+vector<ConjuntoBits> BT_bits(const Matriz& MB, const OpcionesBusqueda& op = OpcionesBusqueda(),
+                             InfoBusqueda* info = nullptr, const Checkpoint* desde = nullptr) {
+    typedef typename MotorBits<N>::Cand Cand;
+    MotorBits<N> E(MB);
+    int COLS = E.columnas;
+
+    vector<Cand> testores;
+
+    auto inicio = chrono::high_resolution_clock::now();
+
+    // Filas cubiertas por b, como OR de las columnas de la transpuesta;
+    // es_testor la llena cuando b no es testor y encontrar_K la reutiliza.
+    vector<uint64_t> cubiertas;
+
+    auto es_subtestor = [&](const Cand& cand) {
+        for (auto& t : testores)
+            if (E.contenido(t, cand)) return true;
+        return false;
+    };
+
+    auto encontrar_ultimo_1 = [&](const Cand& b) {
+        for (int w = E.ancho() - 1; w >= 0; w--)
+            if (b[w]) return w * 64 + msb64(b[w]) + 1;
+        return 0;
+    };
+
+    // b + 1; devuelve false si se sale de las 2^COLS combinaciones
+    auto incrementar = [&](Cand& b) {
+        int j = COLS - 1;
+        while (j >= 0 && MotorBits<N>::tiene(b, j)) {
+            MotorBits<N>::quitar(b, j);
+            j--;
+        }
+        if (j < 0) return false;
+        MotorBits<N>::poner(b, j);
+        return true;
+    };
+
+    Cand b = E.vacio();
+    MotorBits<N>::poner(b, COLS - 1);
+
+    ControlBusqueda ctl(op, desde);
+    if (desde) {
+        b = E.importar(desde->cursor);
+        for (auto& t : desde->conjuntos) testores.push_back(E.importar(t));
+    }
+
+    // Fraccion de las 2^COLS combinaciones que quedan antes del cursor
+    auto cobertura = [&](const Cand& b) {
+        double x = 0, peso = 0.5;
+        for (int j = 0; j < COLS && peso > 0; j++, peso /= 2)
+            if (MotorBits<N>::tiene(b, j)) x += peso;
+        return x;
+    };
+
+    auto checkpoint = [&]() {
+        Checkpoint c;
+        c.alg = 2;
+        c.MB = MB;
+        c.cursor = E.exportar(b);
+        for (auto& t : testores) c.conjuntos.push_back(E.exportar(t));
+        c.nodos = ctl.nodos;
+        c.ms = ctl.ms_previos + ctl.ms();
+        guardar_checkpoint(op.checkpoint, c);
+    };
+
+    bool agotado = false;
+    bool con_limite = !op.limite.empty();
+    Cand limite = con_limite ? E.importar(op.limite) : E.vacio();
+
+    FasePerfil fase("BT busqueda");
+    while (true) {
+        if (con_limite && !E.menor_lex(b, limite)) break;
+        if (ctl.agotado()) {
+            agotado = true;
+            break;
+        }
+        if ((ctl.nodos & 0xFFFF) == 0 && ctl.toca_checkpoint()) checkpoint();
+
+        if (E.es_testor(b, cubiertas)) {
+            if (!es_subtestor(b))
+                testores.push_back(b);
+
+            int k = encontrar_ultimo_1(b);
+            if (k < COLS) {
+                // Sumar 2^(COLS-k) - 1: rellenar con unos tras el ultimo 1
+                for (int j = k; j < COLS; j++) MotorBits<N>::poner(b, j);
+            } else if (!incrementar(b)) {
+                break;
+            }
+        }
+        else {
+            // Usa las filas no cubiertas que dejo es_testor(b) en 'cubiertas'
+            int K = E.encontrar_K(cubiertas);
+            if (K > COLS) {
+                if (!incrementar(b)) break;
+            } else {
+                MotorBits<N>::poner(b, K - 1);
+                for (int j = K; j < COLS; j++) MotorBits<N>::quitar(b, j);
+            }
+        }
+    }
+    fase.terminar();
+
+    auto fin = chrono::high_resolution_clock::now();
+    double ms = chrono::duration<double, milli>(fin - inicio).count();
+
+    if (!op.silencioso)
+        cout << "\n Tiempo total algoritmo BT: "
+             << fixed << setprecision(3) << ms << " ms\n";
+
+    if (agotado && !op.checkpoint.empty()) checkpoint();
+    ctl.cerrar(info, !agotado, agotado ? cobertura(b) : 1.0);
+
+    vector<ConjuntoBits> resultado;
+    resultado.reserve(testores.size());
+    for (auto& t : testores) resultado.push_back(E.exportar(t));
+    return resultado;
+}
+
+// ---------------------------- Despachadores ---------------------------
+
+// Elige la instanciacion segun MB[0].size(): 1, 2, 4 u 8 palabras, o el
+// motor de ancho dinamico para mas de 512 columnas.
+vector<ConjuntoBits> YYC_rapido(const Matriz& MB, const OpcionesBusqueda& op = OpcionesBusqueda(),
+                                InfoBusqueda* info = nullptr, const Checkpoint* desde = nullptr) {
+    if (MB.empty() || MB[0].empty()) return {};   // sin filas o sin columnas: no hay testores
+    int columnas = MB[0].size();
+    if (columnas <= 64) return YYC_bits<1>(MB, op, info, desde);
+    if (columnas <= 128) return YYC_bits<2>(MB, op, info, desde);
+    if (columnas <= 256) return YYC_bits<4>(MB, op, info, desde);
+    if (columnas <= 512) return YYC_bits<8>(MB, op, info, desde);
+    return YYC_bits<0>(MB, op, info, desde);
+}
+
+vector<ConjuntoBits> BT_rapido(const Matriz& MB, const OpcionesBusqueda& op = OpcionesBusqueda(),
+                               InfoBusqueda* info = nullptr, const Checkpoint* desde = nullptr) {
+    if (MB.empty() || MB[0].empty()) return {};   // sin filas o sin columnas: no hay testores
+    int columnas = MB[0].size();
+    if (columnas <= 64) return BT_bits<1>(MB, op, info, desde);
+    if (columnas <= 128) return BT_bits<2>(MB, op, info, desde);
+    if (columnas <= 256) return BT_bits<4>(MB, op, info, desde);
+    if (columnas <= 512) return BT_bits<8>(MB, op, info, desde);
+    return BT_bits<0>(MB, op, info, desde);
+}
+
+// Punto de entrada para continuar una busqueda desde su checkpoint. La
+// matriz y el algoritmo se leen del propio archivo.
+vector<ConjuntoBits> reanudar_busqueda(const string& ruta, const OpcionesBusqueda& op,
+                                       InfoBusqueda& info, int& columnas) {
+    Checkpoint c;
+    if (!cargar_checkpoint(ruta, c) || c.MB.empty()) {
+        cerr << "Error: checkpoint invalido o inexistente: " << ruta << "\n";
+        info.completa = false;
+        info.cobertura = 0;
+        columnas = 0;
+        return {};
+    }
+    columnas = c.MB[0].size();
+    return (c.alg == 1) ? YYC_rapido(c.MB, op, &info, &c) : BT_rapido(c.MB, op, &info, &c);
+}
+
+// ======================================================================
+// ====================== YYC CON FRONTERA EN DISCO =====================
+// ======================================================================
+
+// En filas intermedias de matrices densas la frontera de YYC puede tener
+// decenas de millones de candidatos aunque el resultado final sea chico.
+// YYC_externo limita la memoria de la frontera: la mitad del presupuesto
+// es para los candidatos que se estan generando y, si no caben, se
+// ordenan, se quitan repetidos y se escriben a disco como una corrida;
+// la otra mitad es para leer la frontera anterior, que se recorre con una
+// mezcla de k corridas que tambien quita los repetidos entre corridas.
+//
+// El conjunto de testores es el mismo que el de YYC(); el orden no, porque
+// aqui cada frontera queda ordenada por sus palabras en vez de por orden
+// de aparicion.
+
+const int CORRIDAS_POR_MEZCLA = 64;
+
+struct InfoDisco {
+    long long corridas = 0;         // corridas escritas, incluidas las de mezclas intermedias
+    long long bytes_escritos = 0;
+    long long bytes_leidos = 0;
+    size_t pico_frontera = 0;       // mayor frontera tras quitar repetidos
+    int filas_en_disco = 0;         // filas cuya frontera no cupo en memoria
+};
+
+// Una frontera: en memoria (ordenada y sin repetidos) o en corridas
+template<int N>
+struct FronteraExterna {
+    vector<typename MotorBits<N>::Cand> memoria;
+    vector<string> corridas;
+    size_t tamano = 0;              // candidatos escritos; en disco puede haber repetidos
+};
+
+// Lee una corrida por bloques de 'bloque' candidatos
+template<int N>
+struct LectorCorrida {
+    typedef typename MotorBits<N>::Cand Cand;
+    ifstream in;
+    int nw;
+    vector<uint64_t> buf;
+    size_t pos = 0, cargados = 0;
+    Cand actual;
+    InfoDisco& info;
+
+    LectorCorrida(const string& ruta, int nw, size_t bloque, const Cand& vacio, InfoDisco& info)
+        : in(ruta, ios::binary), nw(nw), buf(bloque * nw), actual(vacio), info(info) {}
+
+    bool avanzar() {
+        if (pos == cargados) {
+            in.read((char*)buf.data(), buf.size() * sizeof(uint64_t));
+            cargados = in.gcount() / (nw * sizeof(uint64_t));
+            info.bytes_leidos += cargados * nw * sizeof(uint64_t);
+            pos = 0;
+            if (cargados == 0) return false;
+        }
+        copy(buf.begin() + pos * nw, buf.begin() + (pos + 1) * nw, actual.begin());
+        ++pos;
+        return true;
+    }
+};
+
+// Mezcla de k corridas ordenadas; 'visitar' recibe cada candidato una vez
+template<int N, class F>
+bool recorrer_corridas(const vector<string>& corridas, const MotorBits<N>& E, size_t bloque,
+                       InfoDisco& info, F visitar) {
+    typedef typename MotorBits<N>::Cand Cand;
+    vector<unique_ptr<LectorCorrida<N>>> lectores;
+    for (auto& r : corridas) {
+        lectores.emplace_back(new LectorCorrida<N>(r, E.nw, bloque, E.vacio(), info));
+        if (!lectores.back()->in) {
+            cerr << "Error: no se pudo abrir la corrida " << r << "\n";
+            return false;
+        }
+    }
+
+    auto mayor = [&](int a, int b) { return lectores[b]->actual < lectores[a]->actual; };
+    priority_queue<int, vector<int>, decltype(mayor)> cola(mayor);
+    for (int i = 0; i < (int)lectores.size(); ++i)
+        if (lectores[i]->avanzar()) cola.push(i);
+
+    Cand ultimo = E.vacio();
+    bool hay_ultimo = false;
+    while (!cola.empty()) {
+        int i = cola.top();
+        cola.pop();
+        if (!hay_ultimo || lectores[i]->actual != ultimo) {
+            ultimo = lectores[i]->actual;
+            hay_ultimo = true;
+            visitar(ultimo);
+        }
+        if (lectores[i]->avanzar()) cola.push(i);
+    }
+    return true;
+}
+
+// Junta los candidatos de una fila y decide si la frontera cabe en memoria
+template<int N>
+struct EscritorFrontera {
+    typedef typename MotorBits<N>::Cand Cand;
+    const MotorBits<N>& E;
+    string dir;
+    size_t capacidad;
+    InfoDisco& info;
+    int& siguiente_id;
+    vector<Cand> buf;
+    FronteraExterna<N> salida;
+    bool ok = true;
+
+    EscritorFrontera(const MotorBits<N>& E, const string& dir, size_t capacidad, InfoDisco& info,
+                     int& siguiente_id)
+        : E(E), dir(dir), capacidad(capacidad), info(info), siguiente_id(siguiente_id) {}
+
+    void agregar(const Cand& c) {
+        buf.push_back(c);
+        if (buf.size() < capacidad) return;
+        // Antes de escribir se compacta: YYC genera muchos repetidos y a
+        // menudo con eso basta para seguir en memoria.
+        ordenar_y_quitar_repetidos();
+        if (buf.size() >= capacidad / 2) volcar();
+    }
+
+    void ordenar_y_quitar_repetidos() {
+        sort(buf.begin(), buf.end());
+        buf.erase(unique(buf.begin(), buf.end()), buf.end());
+    }
+
+    void volcar() {
+        if (buf.empty() || !ok) return;
+        string ruta = dir + "/corrida_" + to_string(siguiente_id++) + ".bin";
+        ofstream out(ruta, ios::binary | ios::trunc);
+        for (auto& c : buf) out.write((const char*)c.data(), E.nw * sizeof(uint64_t));
+        if (!out) {
+            cerr << "Error: no se pudo escribir la corrida " << ruta << "\n";
+            ok = false;
+            return;
+        }
+        info.corridas++;
+        info.bytes_escritos += buf.size() * E.nw * sizeof(uint64_t);
+        salida.tamano += buf.size();
+        salida.corridas.push_back(ruta);
+        buf.clear();
+    }
+
+    FronteraExterna<N> cerrar() {
+        ordenar_y_quitar_repetidos();
+        if (salida.corridas.empty()) {
+            salida.tamano = buf.size();
+            salida.memoria.swap(buf);
+        } else {
+            volcar();
+        }
+        buf.clear();
+        buf.shrink_to_fit();
+        return move(salida);
+    }
+};
+
+template<int N>
+vector<ConjuntoBits> YYC_externo(const Matriz& MB, size_t presupuesto_bytes, const string& dir_base,
+                                 InfoDisco* info_disco = nullptr) {
+    typedef typename MotorBits<N>::Cand Cand;
+    MotorBits<N> E(MB);
+    int filas = E.filas;
+    int columnas = E.columnas;
+
+    InfoDisco info;
+    size_t por_candidato = sizeof(Cand) + (N == 0 ? E.nw * sizeof(uint64_t) : 0);
+    size_t capacidad = max<size_t>(1024, presupuesto_bytes / 2 / por_candidato);
+    size_t bloque = max<size_t>(64, capacidad / CORRIDAS_POR_MEZCLA);
+
+    // Un directorio propio por corrida de YYC; se borra al terminar
+    error_code ec;
+    string dir = (filesystem::path(dir_base.empty() ? filesystem::temp_directory_path(ec).string() : dir_base) /
+                  ("yyc_externo_" + to_string(random_device{}()))).string();
+    filesystem::create_directories(dir, ec);
+    if (ec) {
+        cerr << "Error: no se pudo crear el directorio temporal " << dir << "\n";
+        return {};
+    }
+    int siguiente_id = 0;
+
+    auto borrar = [&](vector<string>& corridas) {
+        for (auto& r : corridas) filesystem::remove(r, ec);
+        corridas.clear();
+    };
+
+    // Con muchas corridas se mezclan por grupos hasta que queden pocas, asi
+    // cada lectura de la fila siguiente abre como mucho CORRIDAS_POR_MEZCLA.
+    auto reducir = [&](FronteraExterna<N>& F) {
+        while ((int)F.corridas.size() > CORRIDAS_POR_MEZCLA) {
+            vector<string> nuevas;
+            for (size_t i = 0; i < F.corridas.size(); i += CORRIDAS_POR_MEZCLA) {
+                vector<string> grupo(F.corridas.begin() + i,
+                                     F.corridas.begin() + min(F.corridas.size(), i + CORRIDAS_POR_MEZCLA));
+                string ruta = dir + "/corrida_" + to_string(siguiente_id++) + ".bin";
+                ofstream out(ruta, ios::binary | ios::trunc);
+                long long escritos = 0;
+                bool ok = recorrer_corridas<N>(grupo, E, bloque, info, [&](const Cand& c) {
+                    out.write((const char*)c.data(), E.nw * sizeof(uint64_t));
+                    ++escritos;
+                });
+                if (!ok || !out) {
+                    cerr << "Error: no se pudo escribir la corrida " << ruta << "\n";
+                    return false;
+                }
+                info.corridas++;
+                info.bytes_escritos += escritos * E.nw * sizeof(uint64_t);
+                borrar(grupo);
+                nuevas.push_back(ruta);
+            }
+            F.corridas.swap(nuevas);
+        }
+        return true;
+    };
+
+    auto inicio = chrono::high_resolution_clock::now();
+
+    FronteraExterna<N> actual;
+    bool ok = true;
+    {
+        EscritorFrontera<N> W(E, dir, capacidad, info, siguiente_id);
+        for (int j = 0; j < columnas; j++)
+            if (MotorBits<N>::tiene(E.M[0], j)) {
+                Cand c = E.vacio();
+                MotorBits<N>::poner(c, j);
+                W.agregar(c);
+            }
+        actual = W.cerrar();
+        ok = W.ok && reducir(actual);
+    }
+
+    vector<uint64_t> uno, dos;
+    vector<int> columnasActivas;
+
+    for (int f = 1; f < filas && ok; f++) {
+        FasePerfil fase("YYC fila", f + 1);
+        const Cand& fila = E.M[f];
+        columnasActivas.clear();
+        for (int j = 0; j < columnas; j++)
+            if (MotorBits<N>::tiene(fila, j))
+                columnasActivas.push_back(j);
+
+        EscritorFrontera<N> W(E, dir, capacidad, info, siguiente_id);
+        auto paso = [&](const Cand& C) {
+            if (E.interseca(fila, C)) {
+                W.agregar(C);
+            } else {
+                for (int col : columnasActivas) {
+                    Cand ext = C;
+                    MotorBits<N>::poner(ext, col);
+                    if (E.cumple_criterios(ext, f, uno, dos))
+                        W.agregar(ext);
+                }
+            }
+        };
+
+        if (actual.corridas.empty()) {
+            for (auto& C : actual.memoria) paso(C);
+        } else {
+            ok = recorrer_corridas<N>(actual.corridas, E, bloque, info, paso);
+            borrar(actual.corridas);
+        }
+        actual = W.cerrar();
+        ok = ok && W.ok && reducir(actual);
+        if (!actual.corridas.empty()) info.filas_en_disco++;
+        info.pico_frontera = max(info.pico_frontera, actual.tamano);
+
+        auto ahora = chrono::high_resolution_clock::now();
+        double ms = chrono::duration<double, milli>(ahora - inicio).count();
+
+        cout << "\n Tiempo acumulado hasta fila " << f + 1 << ": "
+             << fixed << setprecision(3) << ms << " ms\n";
+    }
+
+    vector<ConjuntoBits> resultado;
+    if (ok) {
+        if (actual.corridas.empty()) {
+            for (auto& c : actual.memoria) resultado.push_back(E.exportar(c));
+        } else {
+            ok = recorrer_corridas<N>(actual.corridas, E, bloque, info,
+                                      [&](const Cand& c) { resultado.push_back(E.exportar(c)); });
+        }
+    }
+    borrar(actual.corridas);
+    filesystem::remove_all(dir, ec);
+
+    if (info_disco) *info_disco = info;
+    if (!ok) return {};
+    return resultado;
+}
+
+vector<ConjuntoBits> YYC_externo_rapido(const Matriz& MB, size_t presupuesto_bytes, const string& dir,
+                                        InfoDisco* info = nullptr) {
+    if (MB.empty() || MB[0].empty()) return {};
+    int columnas = MB[0].size();
+    if (columnas <= 64) return YYC_externo<1>(MB, presupuesto_bytes, dir, info);
+    if (columnas <= 128) return YYC_externo<2>(MB, presupuesto_bytes, dir, info);
+    if (columnas <= 256) return YYC_externo<4>(MB, presupuesto_bytes, dir, info);
+    if (columnas <= 512) return YYC_externo<8>(MB, presupuesto_bytes, dir, info);
+    return YYC_externo<0>(MB, presupuesto_bytes, dir, info);
+}
+
+// ======================================================================
+// ========================= YYC EN PROFUNDIDAD =========================
+// ======================================================================
+
+// YYC recorrido en profundidad: cada candidato se extiende por todas las
+// filas restantes antes de pasar al siguiente, y los testores salen en
+// las hojas. La memoria es la de la pila (a lo sumo filas x columnas
+// candidatos) en vez de la frontera mas ancha, mas la tabla de aparece()
+// de cada hilo: entre todos los hilos, a lo sumo 'memo_total' conjuntos
+// (MEMO_PROFUNDIDAD por defecto), cada uno de unos sizeof(Cand) + 48
+// bytes. Con 2^16 entradas son unos 3 MB con N = 1 y 7 MB con N = 8.
+//
+// Sin un conjunto global de vistos, los repetidos se evitan con una regla
+// de extension canonica. Un conjunto S de la frontera tras la fila f solo
+// puede venir de dos padres: S mismo en la frontera anterior (se conserva)
+// o S - {x} extendido con x, donde x es el unico elemento de S en la fila
+// f. Se prefiere siempre conservar: la extension se descarta si S ya
+// estaba en la frontera anterior. Cada conjunto se visita entonces una
+// sola vez por fila y el resultado es el mismo conjunto de testores que
+// YYC(), en otro orden.
+template<int N>
+struct YYCProfundidad {
+    typedef typename MotorBits<N>::Cand Cand;
+    const MotorBits<N>& E;
+    vector<uint64_t> uno, dos;
+    unordered_map<Cand, bool, HashCand<N>> memo;   // aparece(), por conjunto
+    size_t limite_memo;
+
+    YYCProfundidad(const MotorBits<N>& E, size_t limite_memo) : E(E), limite_memo(limite_memo) {}
+
+    // S tiene algun 1 en cada fila 0..g
+    bool cubre_hasta(const Cand& S, int g) {
+        E.cubrir(S, g, uno, dos);
+        int rw = uno.size();
+        for (int r = 0; r < rw - 1; ++r)
+            if (~uno[r]) return false;
+        return uno[rw - 1] == mascara_ultima(g + 1);
+    }
+
+    // Primera fila que S no cubre (E.filas si las cubre todas)
+    int primera_sin_cubrir(const Cand& S) {
+        E.cubrir(S, E.filas - 1, uno);
+        for (size_t r = 0; r < uno.size(); ++r)
+            if (uint64_t falta = ~uno[r])
+                return min<int>(E.filas, r * 64 + ctz64(falta));
+        return E.filas;
+    }
+
+    // S se crea en alguna fila h <= g extendiendo T = S - {x}. Como T tiene
+    // que estar en la frontera tras h - 1 sin cubrir la fila h, h es
+    // forzosamente la primera fila que T no cubre.
+    bool nace_de(const Cand& S, int x, int g) {
+        Cand T = S;
+        MotorBits<N>::quitar(T, x);
+        int h = primera_sin_cubrir(T);
+        return h <= g && MotorBits<N>::tiene(E.M[h], x) && E.cumple_criterios(S, h, uno, dos) &&
+               aparece(T);
+    }
+
+    // S esta en alguna frontera de YYC. Un conjunto que entra en la
+    // frontera sigue en ella mientras cubra las filas siguientes, asi que
+    // T esta tras la fila h - 1 si y solo si aparece y cubre hasta h - 1.
+    // Depende solo de S y se guarda en 'memo'.
+    bool aparece(const Cand& S) {
+        if (E.popcount(S) == 1) return E.interseca(E.M[0], S);
+        auto it = memo.find(S);
+        if (it != memo.end()) return it->second;
+
+        bool si = false;
+        for (int w = 0; w < E.ancho() && !si; ++w)
+            for (uint64_t v = S[w]; v && !si; v &= v - 1) si = nace_de(S, w * 64 + ctz64(v), E.filas - 1);
+        // Llena la tabla, lo nuevo se recalcula cuando haga falta
+        if (memo.size() < limite_memo) memo.emplace(S, si);
+        return si;
+    }
+
+    // S esta en la frontera de YYC tras procesar la fila g: la cubre hasta
+    // g y se creo en una fila no posterior. Cada subconjunto de S se evalua
+    // una sola vez, asi que una consulta cuesta O(2^|S| |S|) recubrimientos
+    // de O(|S| filas / 64) palabras, sin importar g; deshacer la busqueda
+    // fila por fila duplicaba las ramas en cada fila, O(2^g).
+    bool pertenece(const Cand& S, int g) {
+        if (!cubre_hasta(S, g)) return false;
+        if (E.popcount(S) == 1) return E.interseca(E.M[0], S);
+        for (int w = 0; w < E.ancho(); ++w)
+            for (uint64_t v = S[w]; v; v &= v - 1)
+                if (nace_de(S, w * 64 + ctz64(v), g)) return true;
+        return false;
+    }
+
+    // Hijos canonicos de P (que esta en la frontera tras la fila h) en la
+    // frontera tras la fila h + 1
+    template<class F>
+    void expandir(const Cand& P, int h, F visitar) {
+        const Cand& fila = E.M[h + 1];
+        if (E.interseca(fila, P)) {
+            visitar(P);
+            return;
+        }
+        for (int w = 0; w < E.ancho(); ++w)
+            for (uint64_t v = fila[w]; v; v &= v - 1) {
+                Cand ext = P;
+                MotorBits<N>::poner(ext, w * 64 + ctz64(v));
+                if (E.cumple_criterios(ext, h + 1, uno, dos) && !pertenece(ext, h))
+                    visitar(ext);
+            }
+    }
+
+    void recorrer(const Cand& P, int h, vector<ConjuntoBits>& salida) {
+        // Las filas que P ya cubre no abren ramas: se avanza sin recursion
+        while (h + 1 < E.filas && E.interseca(E.M[h + 1], P)) ++h;
+        if (h + 1 == E.filas) {
+            salida.push_back(E.exportar(P));
+            return;
+        }
+        expandir(P, h, [&](const Cand& hijo) { recorrer(hijo, h + 1, salida); });
+    }
+};
+
+// Las primeras filas se expanden a lo ancho hasta tener unas 8 tareas por
+// hilo; cada tarea es un subarbol independiente y los hilos las toman de
+// un contador compartido. El resultado se junta en el orden de las tareas,
+// asi que no depende del numero de hilos. Cada hilo recibe una parte igual
+// de 'memo_total' para su tabla de aparece().
+const size_t MEMO_PROFUNDIDAD = 1 << 16;
+
+template<int N>
+vector<ConjuntoBits> YYC_profundidad(const Matriz& MB, int hilos = 0, size_t memo_total = MEMO_PROFUNDIDAD) {
+    typedef typename MotorBits<N>::Cand Cand;
+    MotorBits<N> E(MB);
+    if (hilos <= 0) hilos = max(1u, thread::hardware_concurrency());
+
+    auto inicio = chrono::high_resolution_clock::now();
+    FasePerfil fase("YYC profundidad");
+
+    size_t limite_memo = memo_total / hilos;
+    vector<Cand> tareas;
+    for (int j = 0; j < E.columnas; j++)
+        if (MotorBits<N>::tiene(E.M[0], j)) {
+            Cand c = E.vacio();
+            MotorBits<N>::poner(c, j);
+            tareas.push_back(c);
+        }
+    int nivel = 0;
+    {
+        // Su tabla se libera antes de que arranquen los hilos
+        YYCProfundidad<N> principal(E, limite_memo);
+        while (!tareas.empty() && tareas.size() < size_t(8 * hilos) && nivel + 1 < E.filas) {
+            vector<Cand> siguientes;
+            for (auto& P : tareas)
+                principal.expandir(P, nivel, [&](const Cand& hijo) { siguientes.push_back(hijo); });
+            tareas.swap(siguientes);
+            nivel++;
+        }
+    }
+
+    vector<vector<ConjuntoBits>> partes(tareas.size());
+    atomic<size_t> siguiente(0);
+    auto trabajar = [&]() {
+        YYCProfundidad<N> Y(E, limite_memo);
+        for (size_t i; (i = siguiente++) < tareas.size();)
+            Y.recorrer(tareas[i], nivel, partes[i]);
+    };
+    vector<thread> pool;
+    for (int t = 1; t < min<int>(hilos, tareas.size()); ++t) pool.emplace_back(trabajar);
+    trabajar();
+    for (auto& t : pool) t.join();
+
+    vector<ConjuntoBits> resultado;
+    for (auto& p : partes) resultado.insert(resultado.end(), p.begin(), p.end());
+    fase.terminar();
+
+    auto fin = chrono::high_resolution_clock::now();
+    double ms = chrono::duration<double, milli>(fin - inicio).count();
+
+    cout << "\n Tiempo total YYC en profundidad: "
+         << fixed << setprecision(3) << ms << " ms\n";
+    return resultado;
+}
+
+vector<ConjuntoBits> YYC_profundidad_rapido(const Matriz& MB, int hilos = 0) {
+    if (MB.empty() || MB[0].empty()) return {};
+    int columnas = MB[0].size();
+    if (columnas <= 64) return YYC_profundidad<1>(MB, hilos);
+    if (columnas <= 128) return YYC_profundidad<2>(MB, hilos);
+    if (columnas <= 256) return YYC_profundidad<4>(MB, hilos);
+    if (columnas <= 512) return YYC_profundidad<8>(MB, hilos);
+    return YYC_profundidad<0>(MB, hilos);
+}
+
+// ======================================================================
+// ========================= EJECUCION EN TUBERIA =======================
+// ======================================================================
+
+// Cola acotada entre dos etapas: push() espera si esta llena, pop() espera
+// si esta vacia y cerrar() avisa que no llegaran mas elementos.
+template<class T>
+class ColaAcotada {
+public:
+    explicit ColaAcotada(size_t capacidad) : capacidad(capacidad) {}
+
+    void push(T x) {
+        unique_lock<mutex> l(m);
+        no_llena.wait(l, [&] { return q.size() < capacidad; });
+        q.push_back(move(x));
+        no_vacia.notify_one();
+    }
+
+    // false cuando la cola esta cerrada y vacia
+    bool pop(T& x) {
+        unique_lock<mutex> l(m);
+        no_vacia.wait(l, [&] { return !q.empty() || cerrada; });
+        return sacar(x);
+    }
+
+    // Sin esperar; 'fin' queda en true si la cola esta cerrada y vacia
+    bool intentar_pop(T& x, bool& fin) {
+        lock_guard<mutex> l(m);
+        fin = cerrada && q.empty();
+        return sacar(x);
+    }
+
+    void cerrar() {
+        lock_guard<mutex> l(m);
+        cerrada = true;
+        no_vacia.notify_all();
+    }
+
+private:
+    bool sacar(T& x) {
+        if (q.empty()) return false;
+        x = move(q.front());
+        q.pop_front();
+        no_llena.notify_one();
+        return true;
+    }
+
+    size_t capacidad;
+    deque<T> q;
+    bool cerrada = false;
+    mutex m;
+    condition_variable no_llena, no_vacia;
+};
+
+// Fila aceptada por el filtro de dominancia, con las que desalojo
+struct EventoMB {
+    int id = -1;
+    vector<uint64_t> fila;
+    vector<int> eliminadas;
+};
+
+struct ResultadoTuberia {
+    vector<ConjuntoBits> testores;
+    Matriz MB;                          // MB final, filas en orden de aceptacion
+    long long generadas = 0, desalojadas = 0, pasos = 0, reinicios = 0;
+    double fin_generador = 0, fin_filtro = 0, fin_yyc = 0, fin_salida = 0;   // ms desde el inicio
+};
+
+// YYC en cuatro etapas concurrentes unidas por colas acotadas:
+//   generador -> filtro de dominancia -> pasos de fila de YYC -> salida
+// El generador llama a generar(i, fila) para cada fila de M. El filtro es
+// FiltroDominancia, que quita repetidas y subfilas como aMatrizBasica().
+// YYC avanza una fila apenas se acepta, sin esperar la MB completa.
+//
+// Ese avance es especulativo: una fila aceptada puede ser desalojada
+// despues por otra que la contiene. Si ya la habia procesado, YYC se
+// reinicia desde la primera fila con las que siguen vivas (se cuenta en
+// 'reinicios'). Las filas vivas quedan en el orden en que se aceptaron, que
+// es el de su primera aparicion en M, el mismo que deja aMatrizBasica();
+// por eso el resultado coincide, en contenido y en orden, con
+// YYC_rapido(aMatrizBasica(M)).
+//
+// La salida escribe en otro hilo las filas de M (con 'mostrar') mientras
+// se generan y al final los testores.
+template<int N, class G>
+ResultadoTuberia YYC_tuberia(int filas, int columnas, G generar, bool mostrar, size_t capacidad_cola = 1024) {
+    typedef typename MotorBits<N>::Cand Cand;
+    ResultadoTuberia R;
+    int nw = palabras_para(columnas);
+
+    ColaAcotada<vector<uint64_t>> cola_filas(capacidad_cola);
+    ColaAcotada<EventoMB> cola_mb(capacidad_cola);
+    ColaAcotada<string> cola_salida(256);
+
+    auto inicio = chrono::high_resolution_clock::now();
+    auto ms = [&] {
+        return chrono::duration<double, milli>(chrono::high_resolution_clock::now() - inicio).count();
+    };
+
+    thread escritor([&] {
+        string s;
+        while (cola_salida.pop(s)) cout << s;
+        cout.flush();
+        R.fin_salida = ms();
+    });
+
+    thread generador([&] {
+        if (mostrar) {
+            ostringstream cab;
+            cab << "\n     ";
+            for (int j = 1; j <= columnas; ++j) cab << setw(3) << j;
+            cab << "\n";
+            cola_salida.push(cab.str());
+        }
+        vector<uint64_t> r(nw);
+        for (int i = 0; i < filas; ++i) {
+            fill(r.begin(), r.end(), 0);
+            generar(i, r);
+            if (mostrar) {
+                ostringstream linea;
+                linea << setw(3) << i + 1 << ": ";
+                for (int j = 0; j < columnas; ++j) linea << setw(3) << ((r[j >> 6] >> (j & 63)) & 1);
+                linea << "\n";
+                cola_salida.push(linea.str());
+            }
+            cola_filas.push(r);
+            R.generadas++;
+        }
+        cola_filas.cerrar();
+        R.fin_generador = ms();
+    });
+
+    thread filtro([&] {
+        FiltroDominancia F(columnas);
+        vector<uint64_t> r;
+        while (cola_filas.pop(r)) {
+            CambioMB c = F.insertar(r.data());
+            if (!c.aceptada) continue;
+            EventoMB ev;
+            ev.id = c.id;
+            ev.fila = move(r);
+            ev.eliminadas = move(c.eliminadas);
+            cola_mb.push(move(ev));
+        }
+        R.desalojadas = F.desalojadas;
+        cola_mb.cerrar();
+        R.fin_filtro = ms();
+    });
+
+    // La etapa de YYC corre en este hilo
+    {
+        struct FilaViva { int id; Cand fila; };
+        MotorBits<N> E(columnas);           // las primeras 'procesadas' filas de 'orden'
+        vector<FilaViva> orden;
+        size_t procesadas = 0;
+        vector<Cand> activos, nuevos;
+        unordered_set<Cand, HashCand<N>> vistos;
+        vector<uint64_t> uno, dos;
+        vector<int> columnasActivas;
+
+        auto aplicar = [&](EventoMB& ev) {
+            if (!ev.eliminadas.empty()) {
+                sort(ev.eliminadas.begin(), ev.eliminadas.end());
+                bool afecta = false;
+                size_t k = 0;
+                for (size_t i = 0; i < orden.size(); ++i) {
+                    if (binary_search(ev.eliminadas.begin(), ev.eliminadas.end(), orden[i].id)) {
+                        afecta = afecta || i < procesadas;
+                        continue;
+                    }
+                    orden[k++] = move(orden[i]);
+                }
+                orden.resize(k);
+                if (afecta) {
+                    R.reinicios++;
+                    E = MotorBits<N>(columnas);
+                    activos.clear();
+                    procesadas = 0;
+                }
+            }
+            Cand c = E.vacio();
+            copy(ev.fila.begin(), ev.fila.end(), c.begin());
+            orden.push_back({ev.id, c});
+        };
+
+        // Mismo paso de fila que YYC_bits()
+        auto paso = [&]() {
+            E.agregar_fila(orden[procesadas++].fila);
+            R.pasos++;
+            int f = E.filas - 1;
+            const Cand& fila = E.M[f];
+
+            columnasActivas.clear();
+            for (int j = 0; j < columnas; j++)
+                if (MotorBits<N>::tiene(fila, j))
+                    columnasActivas.push_back(j);
+
+            if (f == 0) {
+                activos.clear();
+                for (int j : columnasActivas) {
+                    Cand c = E.vacio();
+                    MotorBits<N>::poner(c, j);
+                    activos.push_back(c);
+                }
+                return;
+            }
+
+            nuevos.clear();
+            for (auto& C : activos) {
+                if (E.interseca(fila, C)) {
+                    nuevos.push_back(C);
+                } else {
+                    for (int col : columnasActivas) {
+                        Cand ext = C;
+                        MotorBits<N>::poner(ext, col);
+                        if (E.cumple_criterios(ext, f, uno, dos))
+                            nuevos.push_back(ext);
+                    }
+                }
+            }
+            vistos.clear();
+            activos.clear();
+            for (auto& c : nuevos)
+                if (vistos.insert(c).second)
+                    activos.push_back(c);
+        };
+
+        // Se aplican primero todos los eventos ya disponibles, para no
+        // avanzar sobre filas que ya fueron desalojadas.
+        while (true) {
+            EventoMB ev;
+            bool fin = false;
+            while (cola_mb.intentar_pop(ev, fin)) aplicar(ev);
+            if (procesadas < orden.size()) {
+                paso();
+                continue;
+            }
+            if (fin || !cola_mb.pop(ev)) break;
+            aplicar(ev);
+        }
+
+        for (auto& c : activos) R.testores.push_back(E.exportar(c));
+        for (auto& v : orden) {
+            vector<int> fila(columnas);
+            for (int j = 0; j < columnas; ++j) fila[j] = MotorBits<N>::tiene(v.fila, j);
+            R.MB.push_back(fila);
+        }
+        R.fin_yyc = ms();
+
+        // Despues de las filas de M que el generador ya encolo
+        cola_salida.push("\nTestores YYC:\n");
+        const size_t POR_BLOQUE = 256;
+        for (size_t i = 0; i < R.testores.size(); i += POR_BLOQUE) {
+            ostringstream bloque;
+            for (size_t k = i; k < min(R.testores.size(), i + POR_BLOQUE); ++k) {
+                for (int b : bits_a_vector_binario(R.testores[k], columnas)) bloque << b << " ";
+                bloque << "\n";
+            }
+            cola_salida.push(bloque.str());
+        }
+        cola_salida.cerrar();
+    }
+
+    generador.join();
+    filtro.join();
+    escritor.join();
+    return R;
+}
+
+template<class G>
+ResultadoTuberia YYC_tuberia_rapido(int filas, int columnas, G generar, bool mostrar) {
+    if (columnas <= 64) return YYC_tuberia<1>(filas, columnas, generar, mostrar);
+    if (columnas <= 128) return YYC_tuberia<2>(filas, columnas, generar, mostrar);
+    if (columnas <= 256) return YYC_tuberia<4>(filas, columnas, generar, mostrar);
+    if (columnas <= 512) return YYC_tuberia<8>(filas, columnas, generar, mostrar);
+    return YYC_tuberia<0>(filas, columnas, generar, mostrar);
+}
+
+// ======================================================================
+// ========================= CACHE DE RESULTADOS ========================
+// ======================================================================
+
+// Los resultados de YYC/BT se guardan en disco, indexados por la huella de
+// la matriz basica (antes de ordenar), el algoritmo y el ordenamiento. La
+// cache esta desactivada salvo que TESTORES_CACHE indique un directorio
+// (TESTORES_CACHE=0 tambien la desactiva). El directorio no pasa de
+// TESTORES_CACHE_MB megabytes (256 por defecto): al guardar se borran las
+// entradas usadas hace mas tiempo.
+
+const char MAGIA_CACHE[8] = {'T', 'T', 'C', 'A', 'C', 'H', 'E', '1'};
+const uint32_t VERSION_CACHE = 1;
+
+string directorio_cache() {
+    const char* env = getenv("TESTORES_CACHE");
+    if (!env || !*env || string(env) == "0") return "";
+    return env;
+}
+
+uint64_t limite_cache_bytes() {
+    const char* env = getenv("TESTORES_CACHE_MB");
+    long long mb = env ? atoll(env) : 0;
+    return uint64_t(mb > 0 ? mb : 256) << 20;
+}
+
+// Borra las entradas mas viejas (por ultima escritura, que cargar_cache
+// renueva en cada acierto) hasta que el directorio quepa en el limite.
+void recortar_cache(const string& dir) {
+    error_code ec;
+    vector<pair<filesystem::file_time_type, filesystem::path>> entradas;
+    uint64_t total = 0;
+    for (auto& e : filesystem::directory_iterator(dir, ec)) {
+        if (e.path().extension() != ".bin") continue;
+        uint64_t tam = e.file_size(ec);
+        if (ec) continue;
+        total += tam;
+        entradas.push_back({e.last_write_time(ec), e.path()});
+    }
+    uint64_t limite = limite_cache_bytes();
+    if (total <= limite) return;
+    sort(entradas.begin(), entradas.end());
+    for (auto& e : entradas) {
+        if (total <= limite) break;
+        uint64_t tam = filesystem::file_size(e.second, ec);
+        if (!ec && filesystem::remove(e.second, ec)) total -= tam;
+    }
+}
+
+string ruta_cache(uint64_t huella, int alg, int orden) {
+    ostringstream os;
+    os << directorio_cache() << "/" << hex << setw(16) << setfill('0') << huella
+       << dec << "_" << (alg == 1 ? "yyc" : "bt") << "_" << orden << ".bin";
+    return os.str();
+}
+
+struct CabeceraCache {
+    char magia[8];
+    uint32_t version;
+    uint32_t alg;
+    uint32_t orden;
+    uint32_t filas;
+    uint32_t columnas;
+    uint32_t palabras;
+    uint64_t huella;
+    uint64_t cantidad;
+    double ms_algoritmo;
+};
+
+// Lee un resultado de la cache. Solo se acepta si la cabecera, el tamano
+// del archivo, la matriz basica guardada y la suma de control coinciden con
+// lo esperado; una entrada que no cuadra se borra y cuenta como fallo.
+bool cargar_cache(const MatrizBits& MBb, int alg, int orden,
+                  vector<ConjuntoBits>& testores, double& ms_algoritmo) {
+    if (directorio_cache().empty()) return false;
+    uint64_t huella = huella_matriz(MBb);
+    string ruta = ruta_cache(huella, alg, orden);
+    error_code ec;
+    uint64_t tam = filesystem::file_size(ruta, ec);
+    if (ec) return false;
+
+    auto descartar = [&](ifstream& in) {
+        in.close();
+        filesystem::remove(ruta, ec);
+        return false;
+    };
+
+    ifstream in(ruta, ios::binary);
+    if (!in) return false;
+
+    CabeceraCache c;
+    if (!in.read((char*)&c, sizeof(c))) return descartar(in);
+    if (memcmp(c.magia, MAGIA_CACHE, 8) != 0 || c.version != VERSION_CACHE ||
+        c.alg != uint32_t(alg) || c.orden != uint32_t(orden) || c.huella != huella ||
+        c.filas != uint32_t(MBb.filas) || c.columnas != uint32_t(MBb.columnas) ||
+        c.palabras != uint32_t(MBb.palabras) || c.palabras == 0)
+        return descartar(in);
+
+    // cantidad se comprueba contra el tamano real por division, sin
+    // multiplicar valores leidos del disco que podrian desbordar.
+    uint64_t fijo = sizeof(c) + MBb.datos.size() * sizeof(uint64_t) + sizeof(uint64_t);
+    uint64_t por_testor = uint64_t(c.palabras) * sizeof(uint64_t);
+    if (tam < fijo || (tam - fijo) % por_testor != 0 || (tam - fijo) / por_testor != c.cantidad)
+        return descartar(in);
+
+    vector<uint64_t> mb(MBb.datos.size());
+    if (!in.read((char*)mb.data(), mb.size() * sizeof(uint64_t)) || mb != MBb.datos)
+        return descartar(in);
+
+    vector<uint64_t> datos(c.cantidad * c.palabras);
+    uint64_t suma;
+    if (!in.read((char*)datos.data(), datos.size() * sizeof(uint64_t)) ||
+        !in.read((char*)&suma, sizeof(suma)) ||
+        suma != fnv1a(datos.data(), datos.size() * sizeof(uint64_t), huella))
+        return descartar(in);
+    in.close();
+
+    testores.assign(c.cantidad, ConjuntoBits(c.palabras));
+    for (size_t t = 0; t < c.cantidad; ++t)
+        copy(datos.begin() + t * c.palabras, datos.begin() + (t + 1) * c.palabras, testores[t].begin());
+    ms_algoritmo = c.ms_algoritmo;
+
+    // Acierto: la entrada pasa a ser la mas reciente para recortar_cache()
+    filesystem::last_write_time(ruta, filesystem::file_time_type::clock::now(), ec);
+    return true;
+}
+
+// Escribe en un archivo temporal y lo renombra, para que un corte a mitad
+// de escritura nunca deje una entrada a medias.
+void guardar_cache(const MatrizBits& MBb, int alg, int orden,
+                   const vector<ConjuntoBits>& testores, double ms_algoritmo) {
+    string dir = directorio_cache();
+    if (dir.empty()) return;
+    error_code ec;
+    filesystem::create_directories(dir, ec);
+
+    CabeceraCache c;
+    memcpy(c.magia, MAGIA_CACHE, 8);
+    c.version = VERSION_CACHE;
+    c.alg = alg;
+    c.orden = orden;
+    c.filas = MBb.filas;
+    c.columnas = MBb.columnas;
+    c.palabras = MBb.palabras;
+    c.huella = huella_matriz(MBb);
+    c.cantidad = testores.size();
+    c.ms_algoritmo = ms_algoritmo;
+
+    vector<uint64_t> datos;
+    datos.reserve(testores.size() * c.palabras);
+    for (auto& t : testores) datos.insert(datos.end(), t.begin(), t.end());
+    uint64_t suma = fnv1a(datos.data(), datos.size() * sizeof(uint64_t), c.huella);
+
+    string ruta = ruta_cache(c.huella, alg, orden);
+    string tmp = ruta + ".tmp";
+    {
+        ofstream out(tmp, ios::binary | ios::trunc);
+        if (!out) return;
+        out.write((const char*)&c, sizeof(c));
+        out.write((const char*)MBb.datos.data(), MBb.datos.size() * sizeof(uint64_t));
+        out.write((const char*)datos.data(), datos.size() * sizeof(uint64_t));
+        out.write((const char*)&suma, sizeof(suma));
+        if (!out) return;
+    }
+    filesystem::rename(tmp, ruta, ec);
+    recortar_cache(dir);
+}
+
+// YYC (alg 1) o BT (alg 2) sobre MB_usada, que es MB con el orden pedido.
+// Si el mismo MB, algoritmo y orden ya se resolvieron, se devuelve el
+// resultado guardado sin volver a buscar.
+vector<ConjuntoBits> testores_con_cache(const Matriz& MB, const Matriz& MB_usada, int alg, int orden) {
+    alg = (alg == 1) ? 1 : 2;
+    orden = (orden == 2) ? 2 : 1;
+    MatrizBits MBb = empaquetar(MB);
+    vector<ConjuntoBits> testores;
+    double ms = 0;
+
+    if (cargar_cache(MBb, alg, orden, testores, ms)) {
+        cout << "\n Resultado recuperado de la cache (calculado originalmente en "
+             << fixed << setprecision(3) << ms << " ms)\n";
+        return testores;
+    }
+
+    auto inicio = chrono::high_resolution_clock::now();
+    testores = (alg == 1) ? YYC_rapido(MB_usada) : BT_rapido(MB_usada);
+    auto fin = chrono::high_resolution_clock::now();
+    ms = chrono::duration<double, milli>(fin - inicio).count();
+
+    guardar_cache(MBb, alg, orden, testores, ms);
+    return testores;
+}
+
+// ======================================================================
+// ===================== FORMATO BINARIO DE TESTORES ====================
+// ======================================================================
+
+// Conjunto de testores en disco, mucho mas compacto que el texto 0/1:
+//
+//   CabeceraTestores
+//   bloques: cada testor es la diferencia con el anterior en varint
+//   indice:  por bloque, su posicion en el archivo y su primer testor
+//
+// Cada testor se trata como un entero de 'palabras' palabras (la ultima es
+// la mas significativa). Se guardan ordenados de menor a mayor, asi que las
+// diferencias son positivas y pequenas. El primer testor de cada bloque se
+// guarda como diferencia con cero, de modo que cada bloque se decodifica
+// por separado; el indice permite ir a la posicion i o buscar un testor
+// sin leer el resto. La huella y las filas de la MB de origen permiten
+// comprobar a que matriz pertenece el archivo.
+
+const char MAGIA_TESTORES[8] = {'T', 'T', 'S', 'E', 'T', 'B', 'I', 'N'};
+const uint32_t VERSION_TESTORES = 1;
+const uint32_t TESTORES_POR_BLOQUE = 4096;
+
+struct CabeceraTestores {
+    char magia[8];
+    uint32_t version;
+    uint32_t columnas;
+    uint32_t palabras;
+    uint32_t filas_MB;
+    uint32_t por_bloque;
+    uint32_t bloques;
+    uint64_t cantidad;
+    uint64_t huella;       // huella_matriz de la MB de origen
+    uint64_t pos_indice;   // byte donde empieza el indice
+    uint64_t suma;         // fnv1a de los bloques comprimidos
+};
+
+// Orden de enteros de n palabras
+static bool menor_bits(const uint64_t* a, const uint64_t* b, int n) {
+    for (int k = n - 1; k >= 0; --k)
+        if (a[k] != b[k]) return a[k] < b[k];
+    return false;
+}
+
+// d = b - a, con b >= a
+static void restar_bits(const uint64_t* b, const uint64_t* a, uint64_t* d, int n) {
+    uint64_t prestamo = 0;
+    for (int k = 0; k < n; ++k) {
+        uint64_t x = b[k] - a[k];
+        uint64_t y = x - prestamo;
+        prestamo = (b[k] < a[k]) || (x < prestamo);
+        d[k] = y;
+    }
+}
+
+// a += d
+static void sumar_bits(uint64_t* a, const uint64_t* d, int n) {
+    uint64_t acarreo = 0;
+    for (int k = 0; k < n; ++k) {
+        uint64_t x = a[k] + d[k];
+        uint64_t y = x + acarreo;
+        acarreo = (x < a[k]) || (y < x);
+        a[k] = y;
+    }
+}
+
+// Varint de 7 bits por byte sobre el entero completo de n palabras, de los
+// bits bajos a los altos. v se consume.
+static void escribir_varint(string& out, uint64_t* v, int n) {
+    while (true) {
+        uint8_t byte = v[0] & 0x7f;
+        bool resto = false;
+        for (int k = 0; k < n; ++k) {
+            v[k] = (v[k] >> 7) | (k + 1 < n ? v[k + 1] << 57 : 0);
+            resto |= v[k] != 0;
+        }
+        out += char(resto ? byte | 0x80 : byte);
+        if (!resto) return;
+    }
+}
+
+static bool leer_varint(const char*& p, const char* fin, uint64_t* v, int n) {
+    fill(v, v + n, 0);
+    for (int desp = 0; p < fin && desp < 64 * n; desp += 7) {
+        uint64_t byte = uint8_t(*p++);
+        int w = desp >> 6, b = desp & 63;
+        v[w] |= (byte & 0x7f) << b;
+        if (b > 57 && w + 1 < n) v[w + 1] |= (byte & 0x7f) >> (64 - b);
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+// Escribe los testores ordenados en 'ruta' (via un temporal que se
+// renombra al final). MBb es la matriz basica de la que salieron.
+bool guardar_testores_bin(const string& ruta, const vector<ConjuntoBits>& testores,
+                          int columnas, const MatrizBits& MBb) {
+    int n = palabras_para(columnas);
+    for (auto& t : testores)
+        if ((int)t.size() != n) {
+            cerr << "Error: testores con un ancho distinto al de la matriz.\n";
+            return false;
+        }
+
+    vector<const ConjuntoBits*> orden;
+    orden.reserve(testores.size());
+    for (auto& t : testores) orden.push_back(&t);
+    sort(orden.begin(), orden.end(),
+         [n](const ConjuntoBits* a, const ConjuntoBits* b) { return menor_bits(a->data(), b->data(), n); });
+
+    CabeceraTestores c;
+    memcpy(c.magia, MAGIA_TESTORES, 8);
+    c.version = VERSION_TESTORES;
+    c.columnas = columnas;
+    c.palabras = n;
+    c.filas_MB = MBb.filas;
+    c.por_bloque = TESTORES_POR_BLOQUE;
+    c.bloques = (testores.size() + TESTORES_POR_BLOQUE - 1) / TESTORES_POR_BLOQUE;
+    c.cantidad = testores.size();
+    c.huella = huella_matriz(MBb);
+    c.suma = 1469598103934665603ULL;
+
+    string tmp = ruta + ".tmp";
+    ofstream out(tmp, ios::binary | ios::trunc);
+    if (!out) {
+        cerr << "Error: no se pudo crear " << ruta << "\n";
+        return false;
+    }
+    out.write((const char*)&c, sizeof(c));
+
+    vector<uint64_t> indice;
+    indice.reserve(size_t(c.bloques) * (n + 1));
+    vector<uint64_t> cero(n, 0), d(n);
+    uint64_t pos = sizeof(c);
+    string bloque;
+
+    for (size_t ini = 0; ini < orden.size(); ini += TESTORES_POR_BLOQUE) {
+        size_t fin = min(orden.size(), ini + TESTORES_POR_BLOQUE);
+        indice.push_back(pos);
+        indice.insert(indice.end(), orden[ini]->begin(), orden[ini]->end());
+
+        bloque.clear();
+        const uint64_t* previo = cero.data();
+        for (size_t i = ini; i < fin; ++i) {
+            restar_bits(orden[i]->data(), previo, d.data(), n);
+            escribir_varint(bloque, d.data(), n);
+            previo = orden[i]->data();
+        }
+        out.write(bloque.data(), bloque.size());
+        c.suma = fnv1a(bloque.data(), bloque.size(), c.suma);
+        pos += bloque.size();
+    }
+
+    c.pos_indice = pos;
+    out.write((const char*)indice.data(), indice.size() * sizeof(uint64_t));
+    out.seekp(0);
+    out.write((const char*)&c, sizeof(c));
+    out.close();
+    if (!out) {
+        cerr << "Error: fallo la escritura de " << ruta << "\n";
+        return false;
+    }
+
+    error_code ec;
+    filesystem::rename(tmp, ruta, ec);
+    if (ec) {
+        cerr << "Error: no se pudo renombrar " << tmp << "\n";
+        return false;
+    }
+    return true;
+}
+
+// Lectura en flujo (siguiente) o por posicion (leer, contiene). En flujo
+// solo hay un bloque en memoria a la vez y la suma de control se comprueba
+// al llegar al final; 'error' queda en true si algo no cuadra.
+struct LectorTestores {
+    ifstream in;
+    CabeceraTestores c;
+    vector<uint64_t> indice;   // bloques x (1 + palabras)
+    bool error = false;
+
+    // Estado del recorrido en flujo
+    uint32_t bloque = 0;
+    uint64_t entregados = 0;
+    size_t quedan_en_bloque = 0;
+    string datos;
+    const char* p = nullptr;
+    ConjuntoBits actual;
+    vector<uint64_t> dif;
+    uint64_t suma = 1469598103934665603ULL;
+
+    bool abrir(const string& ruta) {
+        in.open(ruta, ios::binary);
+        if (!in) {
+            cerr << "Error: no se pudo abrir " << ruta << "\n";
+            return false;
+        }
+        in.seekg(0, ios::end);
+        uint64_t tam = in.tellg();
+        in.seekg(0);
+        if (!in.read((char*)&c, sizeof(c)) || memcmp(c.magia, MAGIA_TESTORES, 8) != 0 ||
+            c.version != VERSION_TESTORES || c.palabras != uint32_t(palabras_para(c.columnas)) ||
+            c.por_bloque == 0 || c.bloques != (c.cantidad + c.por_bloque - 1) / c.por_bloque ||
+            c.pos_indice < sizeof(c) ||
+            c.pos_indice + uint64_t(c.bloques) * (c.palabras + 1) * sizeof(uint64_t) != tam) {
+            cerr << "Error: " << ruta << " no es un conjunto de testores valido.\n";
+            return false;
+        }
+        indice.resize(size_t(c.bloques) * (c.palabras + 1));
+        in.seekg(c.pos_indice);
+        if (!in.read((char*)indice.data(), indice.size() * sizeof(uint64_t))) {
+            cerr << "Error: indice incompleto en " << ruta << "\n";
+            return false;
+        }
+        actual.assign(c.palabras, 0);
+        dif.assign(c.palabras, 0);
+        return true;
+    }
+
+    uint64_t inicio_bloque(uint32_t k) const { return indice[size_t(k) * (c.palabras + 1)]; }
+    const uint64_t* primero_bloque(uint32_t k) const { return &indice[size_t(k) * (c.palabras + 1) + 1]; }
+
+    // Lee los bytes comprimidos del bloque k en 'buf'
+    bool cargar_bloque(uint32_t k, string& buf) {
+        uint64_t ini = inicio_bloque(k);
+        uint64_t fin = (k + 1 < c.bloques) ? inicio_bloque(k + 1) : c.pos_indice;
+        if (fin < ini || fin > c.pos_indice) return false;
+        buf.resize(fin - ini);
+        in.clear();
+        in.seekg(ini);
+        return bool(in.read(&buf[0], buf.size()));
+    }
+
+    bool siguiente(ConjuntoBits& t) {
+        if (error || entregados == c.cantidad) return false;
+        int n = c.palabras;
+        if (quedan_en_bloque == 0) {
+            if (!cargar_bloque(bloque, datos)) {
+                error = true;
+                return false;
+            }
+            suma = fnv1a(datos.data(), datos.size(), suma);
+            p = datos.data();
+            quedan_en_bloque = min<uint64_t>(c.por_bloque, c.cantidad - entregados);
+            fill(actual.begin(), actual.end(), 0);
+            bloque++;
+        }
+        if (!leer_varint(p, datos.data() + datos.size(), dif.data(), n)) {
+            error = true;
+            return false;
+        }
+        sumar_bits(actual.data(), dif.data(), n);
+        quedan_en_bloque--;
+        entregados++;
+        if (entregados == c.cantidad && suma != c.suma) error = true;
+        t = actual;
+        return !error;
+    }
+
+    // Testor en la posicion i del orden del archivo
+    bool leer(uint64_t i, ConjuntoBits& t) {
+        if (i >= c.cantidad) return false;
+        int n = c.palabras;
+        string buf;
+        if (!cargar_bloque(i / c.por_bloque, buf)) return false;
+        const char* q = buf.data();
+        vector<uint64_t> d(n);
+        t.assign(n, 0);
+        for (uint64_t k = 0; k <= i % c.por_bloque; ++k) {
+            if (!leer_varint(q, buf.data() + buf.size(), d.data(), n)) return false;
+            sumar_bits(t.data(), d.data(), n);
+        }
+        return true;
+    }
+
+    // Busqueda binaria en el indice y recorrido de un solo bloque
+    bool contiene(const ConjuntoBits& t) {
+        int n = c.palabras;
+        if ((int)t.size() != n || c.bloques == 0) return false;
+        uint32_t lo = 0, hi = c.bloques;
+        while (hi - lo > 1) {
+            uint32_t m = (lo + hi) / 2;
+            if (menor_bits(t.data(), primero_bloque(m), n)) hi = m;
+            else lo = m;
+        }
+        string buf;
+        if (!cargar_bloque(lo, buf)) return false;
+        const char* q = buf.data();
+        uint64_t cuantos = min<uint64_t>(c.por_bloque, c.cantidad - uint64_t(lo) * c.por_bloque);
+        vector<uint64_t> v(n, 0), d(n);
+        for (uint64_t k = 0; k < cuantos; ++k) {
+            if (!leer_varint(q, buf.data() + buf.size(), d.data(), n)) return false;
+            sumar_bits(v.data(), d.data(), n);
+            if (!menor_bits(v.data(), t.data(), n)) return !menor_bits(t.data(), v.data(), n);
+        }
+        return false;
+    }
+};
+
+// Convierte un archivo binario al texto de siempre (una fila 0/1 por
+// testor, en el orden del archivo). Devuelve cuantos se escribieron o -1.
+long long bin_a_texto(const string& ruta, ostream& out) {
+    LectorTestores L;
+    if (!L.abrir(ruta)) return -1;
+    ConjuntoBits t;
+    string linea;
+    long long escritos = 0;
+    while (L.siguiente(t)) {
+        linea.clear();
+        for (uint32_t j = 0; j < L.c.columnas; ++j) {
+            linea += char('0' + ((t[j >> 6] >> (j & 63)) & 1));
+            linea += ' ';
+        }
+        linea += '\n';
+        out << linea;
+        escritos++;
+    }
+    if (L.error) {
+        cerr << "Error: " << ruta << " esta danado (datos o suma de control).\n";
+        return -1;
+    }
+    return escritos;
+}
+
+// ======================================================================
+// ======================== BUSQUEDA DISTRIBUIDA ========================
+// ======================================================================
+
+// Una busqueda grande se parte en fragmentos independientes que resuelven
+// procesos trabajadores: el mismo programa lanzado con --trabajador, que
+// lee fragmentos por stdin y devuelve testores por stdout. El coordinador
+// reparte fragmentos a medida que los trabajadores quedan libres y al
+// final une los resultados quitando los conjuntos no minimales.
+//
+// Por defecto los trabajadores son procesos locales. Con la variable
+// TESTORES_LANZADOR (p. ej. "ssh nodo3") cada trabajador se lanza como
+// "$TESTORES_LANZADOR <programa> --trabajador", lo que permite usar otras
+// maquinas sin servicios adicionales.
+
+// Punto de partida de un fragmento y, en BT, el n-uplo donde termina
+struct Fragmento {
+    Checkpoint estado;
+    ConjuntoBits limite;
+};
+
+string ruta_programa = "testores";
+
+vector<ConjuntoBits> resolver_fragmento(const Fragmento& f) {
+    OpcionesBusqueda op;
+    op.limite = f.limite;
+    if (f.estado.alg == 1) return YYC_rapido(f.estado.MB, op, nullptr, &f.estado);
+    return BT_rapido(f.estado.MB, op, nullptr, &f.estado);
+}
+
+// Une los resultados de los fragmentos en orden, quitando repetidos
+vector<ConjuntoBits> fusionar(const vector<vector<ConjuntoBits>>& partes) {
+    vector<ConjuntoBits> todos;
+    set<ConjuntoBits> vistos;
+    for (auto& p : partes)
+        for (auto& c : p)
+            if (vistos.insert(c).second) todos.push_back(c);
+    return todos;
+}
+
+// Como fusionar(), pero quitando ademas los conjuntos que contienen
+// estrictamente a otro. Hace falta en BT: cada fragmento solo descarta
+// supertestores de los testores que encontro el mismo.
+vector<ConjuntoBits> fusionar_minimales(const vector<vector<ConjuntoBits>>& partes) {
+    vector<ConjuntoBits> todos = fusionar(partes);
+
+    // Se revisan de menor a mayor cardinalidad contra los ya aceptados
+    vector<int> cardinal(todos.size()), idx(todos.size());
+    for (size_t i = 0; i < todos.size(); ++i) {
+        cardinal[i] = kernels().popcount(todos[i].data(), todos[i].size());
+        idx[i] = i;
+    }
+    stable_sort(idx.begin(), idx.end(), [&](int a, int b) { return cardinal[a] < cardinal[b]; });
+
+    vector<char> keep(todos.size(), 1);
+    vector<int> aceptados;
+    for (int i : idx) {
+        for (int k : aceptados)
+            if (cardinal[k] < cardinal[i] &&
+                kernels().es_subfila(todos[k].data(), todos[i].data(), todos[i].size())) {
+                keep[i] = 0;
+                break;
+            }
+        if (keep[i]) aceptados.push_back(i);
+    }
+
+    vector<ConjuntoBits> out;
+    for (size_t i = 0; i < todos.size(); ++i)
+        if (keep[i]) out.push_back(todos[i]);
+    return out;
+}
+
+// Mensajes: [uint64 longitud][datos]. Un fragmento es
+// [uint32 palabras del limite][limite][checkpoint]; un resultado es
+// [uint64 cantidad][uint32 palabras][conjuntos]. Longitud 0 = terminar.
+
+string serializar_fragmento(const Fragmento& f) {
+    uint32_t nl = f.limite.size();
+    string out((const char*)&nl, sizeof(nl));
+    out.append((const char*)f.limite.data(), nl * sizeof(uint64_t));
+    out += serializar_checkpoint(f.estado);
+    return out;
+}
+
+bool deserializar_fragmento(const string& in, Fragmento& f) {
+    uint32_t nl;
+    if (in.size() < sizeof(nl)) return false;
+    memcpy(&nl, in.data(), sizeof(nl));
+    size_t inicio = sizeof(nl) + nl * sizeof(uint64_t);
+    if (in.size() < inicio) return false;
+    f.limite.assign(nl, 0);
+    memcpy(f.limite.data(), in.data() + sizeof(nl), nl * sizeof(uint64_t));
+    return deserializar_checkpoint(in.substr(inicio), f.estado);
+}
+
+string serializar_conjuntos(const vector<ConjuntoBits>& v) {
+    uint64_t cantidad = v.size();
+    uint32_t nw = v.empty() ? 0 : v[0].size();
+    string out((const char*)&cantidad, sizeof(cantidad));
+    out.append((const char*)&nw, sizeof(nw));
+    for (auto& c : v) out.append((const char*)c.data(), nw * sizeof(uint64_t));
+    return out;
+}
+
+bool deserializar_conjuntos(const string& in, vector<ConjuntoBits>& v) {
+    uint64_t cantidad;
+    uint32_t nw;
+    if (in.size() < sizeof(cantidad) + sizeof(nw)) return false;
+    memcpy(&cantidad, in.data(), sizeof(cantidad));
+    memcpy(&nw, in.data() + sizeof(cantidad), sizeof(nw));
+    const char* p = in.data() + sizeof(cantidad) + sizeof(nw);
+    if (in.size() != sizeof(cantidad) + sizeof(nw) + cantidad * nw * sizeof(uint64_t)) return false;
+    v.assign(cantidad, ConjuntoBits(nw));
+    for (auto& c : v) {
+        memcpy(c.data(), p, nw * sizeof(uint64_t));
+        p += nw * sizeof(uint64_t);
+    }
+    return true;
+}
+
+#ifdef TESTORES_POSIX
+
+static bool escribir_todo(int fd, const char* p, size_t n) {
+    while (n > 0) {
+        ssize_t k = write(fd, p, n);
+        if (k < 0 && errno == EINTR) continue;
+        if (k <= 0) return false;
+        p += k;
+        n -= k;
+    }
+    return true;
+}
+
+static bool leer_todo(int fd, char* p, size_t n) {
+    while (n > 0) {
+        ssize_t k = read(fd, p, n);
+        if (k < 0 && errno == EINTR) continue;
+        if (k <= 0) return false;
+        p += k;
+        n -= k;
+    }
+    return true;
+}
+
+bool enviar_mensaje(int fd, const string& datos) {
+    uint64_t n = datos.size();
+    return escribir_todo(fd, (const char*)&n, sizeof(n)) && escribir_todo(fd, datos.data(), n);
+}
+
+bool recibir_mensaje(int fd, string& datos) {
+    uint64_t n;
+    if (!leer_todo(fd, (char*)&n, sizeof(n))) return false;
+    datos.resize(n);
+    return leer_todo(fd, &datos[0], n);
+}
+
+// Bucle del proceso trabajador. cout se silencia porque stdout es el canal
+// con el coordinador y los motores imprimen sus tiempos por cout.
+int modo_trabajador() {
+    cout.rdbuf(nullptr);
+    string msg;
+    Fragmento f;
+    while (recibir_mensaje(0, msg) && !msg.empty()) {
+        if (!deserializar_fragmento(msg, f)) return 1;
+        if (!enviar_mensaje(1, serializar_conjuntos(resolver_fragmento(f)))) return 1;
+    }
+    return 0;
+}
+
+struct Trabajador {
+    pid_t pid = -1;
+    int entrada = -1;   // stdin del trabajador
+    int salida = -1;    // stdout del trabajador
+    int tarea = -1;     // fragmento en curso, -1 si esta libre
+};
+
+bool lanzar_trabajador(Trabajador& t) {
+    int a[2], b[2];
+    if (pipe(a) != 0) return false;
+    if (pipe(b) != 0) {
+        close(a[0]); close(a[1]);
+        return false;
+    }
+
+    const char* lanzador = getenv("TESTORES_LANZADOR");
+    string comando = string(lanzador ? lanzador : "") + " '" + ruta_programa + "' --trabajador";
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(a[0]); close(a[1]); close(b[0]); close(b[1]);
+        return false;
+    }
+    if (pid == 0) {
+#ifdef __linux__
+        prctl(PR_SET_PDEATHSIG, SIGTERM);   // no dejar huerfanos si el coordinador muere
+#endif
+        dup2(a[0], 0);
+        dup2(b[1], 1);
+        close(a[0]); close(a[1]); close(b[0]); close(b[1]);
+        if (lanzador && *lanzador)
+            execl("/bin/sh", "sh", "-c", comando.c_str(), (char*)nullptr);
+        else
+            execl(ruta_programa.c_str(), ruta_programa.c_str(), "--trabajador", (char*)nullptr);
+        _exit(127);
+    }
+    close(a[0]);
+    close(b[1]);
+    t.pid = pid;
+    t.entrada = a[1];
+    t.salida = b[0];
+    t.tarea = -1;
+    return true;
+}
+
+void cerrar_trabajador(Trabajador& t) {
+    if (t.entrada >= 0) close(t.entrada);
+    if (t.salida >= 0) close(t.salida);
+    if (t.pid > 0) waitpid(t.pid, nullptr, 0);
+    t = Trabajador();
+}
+
+// Reparte los fragmentos entre 'procesos' trabajadores. Si un trabajador
+// muere, su fragmento vuelve a la cola; si mueren todos, lo que falte se
+// resuelve en este proceso.
+vector<vector<ConjuntoBits>> ejecutar_fragmentos(const vector<Fragmento>& tareas, int procesos) {
+    vector<vector<ConjuntoBits>> resultados(tareas.size());
+    deque<int> pendientes;
+    for (size_t i = 0; i < tareas.size(); ++i) pendientes.push_back(i);
+
+    signal(SIGPIPE, SIG_IGN);
+    vector<Trabajador> trab(max(1, min<int>(procesos, tareas.size())));
+    for (auto& t : trab)
+        if (!lanzar_trabajador(t)) t = Trabajador();
+
+    auto asignar = [&](Trabajador& t) {
+        while (!pendientes.empty()) {
+            int k = pendientes.front();
+            if (!enviar_mensaje(t.entrada, serializar_fragmento(tareas[k]))) {
+                cerrar_trabajador(t);
+                return;
+            }
+            pendientes.pop_front();
+            t.tarea = k;
+            return;
+        }
+        enviar_mensaje(t.entrada, "");
+        cerrar_trabajador(t);
+    };
+    for (auto& t : trab)
+        if (t.pid > 0) asignar(t);
+
+    while (true) {
+        vector<pollfd> fds;
+        vector<int> quien;
+        for (size_t i = 0; i < trab.size(); ++i)
+            if (trab[i].pid > 0 && trab[i].tarea >= 0) {
+                fds.push_back({trab[i].salida, POLLIN, 0});
+                quien.push_back(i);
+            }
+        if (fds.empty()) break;
+        if (poll(fds.data(), fds.size(), -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        for (size_t j = 0; j < fds.size(); ++j) {
+            if (!(fds[j].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+            Trabajador& t = trab[quien[j]];
+            string msg;
+            if (recibir_mensaje(t.salida, msg) && deserializar_conjuntos(msg, resultados[t.tarea])) {
+                t.tarea = -1;
+                asignar(t);
+            } else {
+                cerr << "Aviso: un trabajador termino inesperadamente; su fragmento se reasigna.\n";
+                pendientes.push_back(t.tarea);
+                t.tarea = -1;
+                cerrar_trabajador(t);
+                for (auto& otro : trab)
+                    if (otro.pid > 0 && otro.tarea < 0) asignar(otro);
+            }
+        }
+    }
+
+    for (auto& t : trab)
+        if (t.pid > 0) cerrar_trabajador(t);
+
+    // Sin trabajadores vivos: resolver aqui lo que quede
+    for (int k : pendientes) resultados[k] = resolver_fragmento(tareas[k]);
+    return resultados;
+}
+
+#else
+
+int modo_trabajador() {
+    cerr << "Error: el modo trabajador solo esta disponible en sistemas POSIX.\n";
+    return 1;
+}
+
+// Sin procesos: los fragmentos se resuelven en serie en este proceso
+vector<vector<ConjuntoBits>> ejecutar_fragmentos(const vector<Fragmento>& tareas, int) {
+    vector<vector<ConjuntoBits>> resultados;
+    for (auto& f : tareas) resultados.push_back(resolver_fragmento(f));
+    return resultados;
+}
+
+#endif // TESTORES_POSIX
+
+// BT por rangos de prefijo: el fragmento k recorre los n-uplos cuyas
+// primeras 'bits_prefijo' columnas forman el numero k.
+vector<ConjuntoBits> BT_distribuido(const Matriz& MB, int procesos, int bits_prefijo) {
+    int COLS = MB[0].size();
+    int p = max(0, min({bits_prefijo, COLS - 1, 20}));
+    int nw = palabras_para(COLS);
+
+    auto prefijo = [&](long long k) {
+        ConjuntoBits c(nw, 0);
+        for (int j = 0; j < p; ++j)
+            if ((k >> (p - 1 - j)) & 1) c[j >> 6] |= 1ULL << (j & 63);
+        return c;
+    };
+
+    vector<Fragmento> tareas;
+    for (long long k = 0; k < (1LL << p); ++k) {
+        Fragmento f;
+        f.estado.alg = 2;
+        f.estado.MB = MB;
+        f.estado.cursor = prefijo(k);
+        if (k == 0) f.estado.cursor[(COLS - 1) >> 6] |= 1ULL << ((COLS - 1) & 63);
+        if (k + 1 < (1LL << p)) f.limite = prefijo(k + 1);
+        tareas.push_back(f);
+    }
+    return fusionar_minimales(ejecutar_fragmentos(tareas, procesos));
+}
+
+// YYC por particion de la frontera: se procesan aqui las primeras
+// 'filas_iniciales' filas y los activos resultantes se reparten en
+// 'fragmentos' grupos que continuan por separado desde esa fila.
+vector<ConjuntoBits> YYC_distribuido(const Matriz& MB, int procesos, int filas_iniciales, int fragmentos) {
+    int filas = MB.size();
+    int k = max(1, min(filas_iniciales, filas));
+    Matriz prefijo(MB.begin(), MB.begin() + k);
+    vector<ConjuntoBits> frontera = YYC_rapido(prefijo);
+    if (k == filas) return frontera;
+
+    int partes = max(1, min<int>(fragmentos, frontera.size()));
+    vector<Fragmento> tareas(partes);
+    for (auto& f : tareas) {
+        f.estado.alg = 1;
+        f.estado.MB = MB;
+        f.estado.fila = k;
+    }
+    for (size_t i = 0; i < frontera.size(); ++i)
+        tareas[i % partes].estado.conjuntos.push_back(frontera[i]);
+
+    // Cada fila de YYC extiende cada activo por separado, asi que la union
+    // de los fragmentos es exactamente la frontera final de la version serie.
+    return fusionar(ejecutar_fragmentos(tareas, procesos));
+}
+
+// ======================================================================
+// ======================= PROCESAMIENTO POR LOTES ======================
+// ======================================================================
+
+// Un manifiesto es un archivo de texto con una matriz por linea:
+//
+//   archivo <ruta> [yyc|bt] [normal|ascendente]
+//   aleatoria <filas> <columnas> <densidad> <semilla> [yyc|bt] [normal|ascendente]
+//   theta | gamma [yyc|bt] [normal|ascendente]            (entre A y B)
+//   phi_n <n> | gamma_n <n> [yyc|bt] [normal|ascendente]  (desde theta(A, B))
+//
+// phi(A, B) no es una entrada: pide el mismo numero de filas y A y B no lo
+// tienen.
+//
+// Las lineas vacias o que empiezan por '#' se ignoran y las rutas relativas
+// se toman desde el directorio del manifiesto. Cada matriz es una tarea:
+// son demasiado pequenas para repartir una sola entre hilos, asi que se
+// reparten las matrices. La salida es un unico texto en el orden del
+// manifiesto, sin importar que hilo resolvio cada una.
+
+// Matrices basicas A y B del articulo base (las de las opciones 4 y 5)
+const Matriz MB_A_ARTICULO = {
+    {0,0,1,1,0,1},
+    {0,1,0,1,1,1},
+    {1,1,1,1,0,0},
+    {1,0,0,1,0,1}
+};
+
+const Matriz MB_B_ARTICULO = {
+    {1,1,1,0,0,0},
+    {1,0,1,0,1,0},
+    {0,0,0,1,0,0},
+    {1,0,0,0,0,1},
+    {0,1,0,0,0,1},
+    {0,0,1,0,0,1}
+};
+
+struct EntradaLote {
+    string tipo;
+    string ruta;
+    int filas = 0;
+    int columnas = 0;
+    double densidad = 0.5;
+    uint64_t semilla = 0;
+    int n = 0;
+    int alg = 1;
+    int orden = 1;
+    string descripcion;   // la linea del manifiesto
+    double costo = 1;     // estimado, solo sirve para ordenar las tareas
+};
+
+// Lee una matriz booleana en texto, una fila por linea. Los valores pueden
+// ir separados por espacios, tabuladores, comas o punto y coma, o juntos
+// ("010110"). Las lineas vacias o que empiezan por '#' se ignoran. Las
+// filas de M que ya existian se reutilizan para no volver a reservarlas.
+bool leer_matriz(const string& ruta, Matriz& M) {
+    ifstream in(ruta);
+    if (!in) {
+        cerr << "Error: no se pudo abrir " << ruta << "\n";
+        return false;
+    }
+
+    size_t filas = 0;
+    string linea;
+    int num_linea = 0;
+
+    while (getline(in, linea)) {
+        num_linea++;
+        size_t p = linea.find_first_not_of(" \t\r");
+        if (p == string::npos || linea[p] == '#') continue;
+
+        if (filas == M.size()) M.emplace_back();
+        vector<int>& fila = M[filas];
+        fila.clear();
+        for (char ch : linea) {
+            if (ch == '0' || ch == '1') fila.push_back(ch - '0');
+            else if (ch != ' ' && ch != '\t' && ch != ',' && ch != ';' && ch != '\r') {
+                cerr << "Error: " << ruta << ", linea " << num_linea << ": valor no binario.\n";
+                return false;
+            }
+        }
+        if (filas > 0 && fila.size() != M[0].size()) {
+            cerr << "Error: " << ruta << ", linea " << num_linea << " con numero de columnas distinto.\n";
+            return false;
+        }
+        filas++;
+    }
+    M.resize(filas);
+    return filas > 0 && !M[0].empty();
+}
+
+// Costo relativo de resolver una matriz de filas x columnas. YYC y BT
+// crecen mucho mas con las columnas que con las filas; no hace falta que
+// sea exacto, solo que ordene bien las tareas grandes frente a las chicas.
+double costo_estimado(double filas, double columnas) {
+    return max(1.0, filas * columnas * columnas);
+}
+
+// Dimensiones sin construir la matriz; para un archivo se cuentan las
+// columnas de la primera fila y las filas se deducen del tamano.
+void estimar_costo(EntradaLote& e) {
+    double filas = 0, columnas = 0;
+    double fA = MB_A_ARTICULO.size(), fB = MB_B_ARTICULO.size();
+    double cA = MB_A_ARTICULO[0].size(), cB = MB_B_ARTICULO[0].size();
+
+    if (e.tipo == "aleatoria") {
+        filas = e.filas;
+        columnas = e.columnas;
+    } else if (e.tipo == "theta" || e.tipo == "phi_n" || e.tipo == "gamma_n") {
+        filas = fA * fB;
+        columnas = cA + cB;
+        double copias = double(1ULL << e.n);
+        if (e.tipo == "phi_n") columnas *= copias;
+        if (e.tipo == "gamma_n") filas *= copias, columnas *= copias;
+    } else if (e.tipo == "gamma") {
+        filas = fA + fB;
+        columnas = cA + cB;
+    } else if (e.tipo == "archivo") {
+        ifstream in(e.ruta);
+        string linea;
+        while (getline(in, linea)) {
+            size_t p = linea.find_first_not_of(" \t\r");
+            if (p == string::npos || linea[p] == '#') continue;
+            columnas = count(linea.begin(), linea.end(), '0') + count(linea.begin(), linea.end(), '1');
+            error_code ec;
+            auto bytes = filesystem::file_size(e.ruta, ec);
+            filas = ec ? 1 : double(bytes) / (linea.size() + 1);
+            break;
+        }
+    }
+    e.costo = costo_estimado(filas, columnas);
+}
+
+bool leer_manifiesto(const string& ruta, vector<EntradaLote>& entradas) {
+    ifstream in(ruta);
+    if (!in) {
+        cerr << "Error: no se pudo abrir " << ruta << "\n";
+        return false;
+    }
+
+    filesystem::path base = filesystem::path(ruta).parent_path();
+    entradas.clear();
+    string linea;
+    int num_linea = 0;
+
+    while (getline(in, linea)) {
+        num_linea++;
+        if (!linea.empty() && linea.back() == '\r') linea.pop_back();
+        istringstream ss(linea);
+        vector<string> campos;
+        string campo;
+        while (ss >> campo) campos.push_back(campo);
+        if (campos.empty() || campos[0][0] == '#') continue;
+
+        EntradaLote e;
+        e.tipo = campos[0];
+        e.descripcion = linea.substr(linea.find_first_not_of(" \t"));
+        size_t usados = 1;
+        bool ok = true;
+
+        try {
+            if (e.tipo == "archivo" && campos.size() >= 2) {
+                filesystem::path p(campos[1]);
+                e.ruta = (p.is_relative() ? base / p : p).string();
+                usados = 2;
+            } else if (e.tipo == "aleatoria" && campos.size() >= 5) {
+                e.filas = stoi(campos[1]);
+                e.columnas = stoi(campos[2]);
+                e.densidad = stod(campos[3]);
+                e.semilla = stoull(campos[4]);
+                ok = e.filas > 0 && e.columnas > 0 && e.densidad >= 0 && e.densidad <= 1;
+                usados = 5;
+            } else if ((e.tipo == "phi_n" || e.tipo == "gamma_n") && campos.size() >= 2) {
+                e.n = stoi(campos[1]);
+                ok = e.n >= 0 && e.n <= 30;
+                usados = 2;
+            } else {
+                ok = e.tipo == "theta" || e.tipo == "gamma";
+            }
+        } catch (const exception&) {
+            ok = false;
+        }
+
+        for (size_t k = usados; ok && k < campos.size(); ++k) {
+            if (campos[k] == "yyc") e.alg = 1;
+            else if (campos[k] == "bt") e.alg = 2;
+            else if (campos[k] == "normal") e.orden = 1;
+            else if (campos[k] == "ascendente") e.orden = 2;
+            else ok = false;
+        }
+
+        if (!ok) {
+            cerr << "Error: " << ruta << ", linea " << num_linea << ": entrada no valida.\n";
+            return false;
+        }
+        estimar_costo(e);
+        entradas.push_back(e);
+    }
+    return !entradas.empty();
+}
+
+// Memoria que cada hilo reutiliza de una tarea a la siguiente: la matriz
+// de entrada y el texto del bloque de salida conservan su capacidad.
+struct ArenaLote {
+    Matriz M;
+    string texto;
+};
+
+bool construir_matriz(const EntradaLote& e, Matriz& M) {
+    if (e.tipo == "archivo") return leer_matriz(e.ruta, M);
+
+    if (e.tipo == "aleatoria") {
+        mt19937_64 gen(e.semilla);
+        bernoulli_distribution dist(e.densidad);
+        M.resize(e.filas);
+        for (auto& fila : M) {
+            fila.resize(e.columnas);
+            for (int& v : fila) v = dist(gen);
+        }
+        return true;
+    }
+
+    if (e.tipo == "theta") M = theta(MB_A_ARTICULO, MB_B_ARTICULO);
+    else if (e.tipo == "gamma") M = gamma(MB_A_ARTICULO, MB_B_ARTICULO);
+    else if (e.tipo == "phi_n") M = phi_n(theta(MB_A_ARTICULO, MB_B_ARTICULO), e.n);
+    else if (e.tipo == "gamma_n") M = gamma_n(theta(MB_A_ARTICULO, MB_B_ARTICULO), e.n);
+    return !M.empty() && !M[0].empty();
+}
+
+// Junta los bloques de texto de las tareas y los escribe en el orden del
+// manifiesto: un bloque que llega antes de su turno espera en 'pendientes'
+// y se escribe en cuanto se completan los anteriores.
+struct SalidaLote {
+    ostream& out;
+    mutex m;
+    vector<string> pendientes;
+    vector<char> listo;
+    size_t siguiente = 0;
+
+    SalidaLote(ostream& out, size_t n) : out(out), pendientes(n), listo(n, 0) {}
+
+    void entregar(size_t i, const string& texto) {
+        lock_guard<mutex> lk(m);
+        if (i != siguiente) {
+            pendientes[i] = texto;
+            listo[i] = 1;
+            return;
+        }
+        out << texto;
+        siguiente++;
+        while (siguiente < listo.size() && listo[siguiente]) {
+            out << pendientes[siguiente];
+            string().swap(pendientes[siguiente]);
+            siguiente++;
+        }
+    }
+};
+
+struct InfoLote {
+    size_t matrices = 0;
+    size_t fallidas = 0;
+    size_t testores = 0;
+    double ms = 0;
+    vector<size_t> tareas_por_hilo;
+    vector<size_t> robadas_por_hilo;
+};
+
+// Resuelve una entrada y deja su bloque de salida en arena.texto:
+//   # matriz <i>: <linea del manifiesto>
+//   # filas F, columnas C, filas de MB R, YYC|BT, orden normal|ascendente, testores K, T ms
+//   <un testor por linea, como en el menu>
+bool resolver_entrada(const EntradaLote& e, size_t indice, bool con_testores,
+                      ArenaLote& arena, size_t& cantidad) {
+    string& t = arena.texto;
+    t.clear();
+    t += "# matriz " + to_string(indice + 1) + ": " + e.descripcion + "\n";
+    cantidad = 0;
+
+    if (!construir_matriz(e, arena.M)) {
+        t += "# error: no se pudo construir la matriz\n";
+        return false;
+    }
+
+    auto inicio = chrono::high_resolution_clock::now();
+    Matriz MB = aMatrizBasica(arena.M);
+    if (MB.empty() || MB[0].empty()) {
+        t += "# error: la matriz basica esta vacia, no hay testores\n";
+        return false;
+    }
+    Matriz MB_usada = (e.orden == 2) ? ordenar_filas_por_unos(MB) : MB;
+    OpcionesBusqueda op;
+    op.silencioso = true;
+    vector<ConjuntoBits> testores = (e.alg == 1) ? YYC_rapido(MB_usada, op) : BT_rapido(MB_usada, op);
+    double ms = chrono::duration<double, milli>(chrono::high_resolution_clock::now() - inicio).count();
+
+    int columnas = arena.M[0].size();
+    cantidad = testores.size();
+    ostringstream os;
+    os << "# filas " << arena.M.size() << ", columnas " << columnas
+       << ", filas de MB " << MB.size() << ", " << (e.alg == 1 ? "YYC" : "BT")
+       << ", orden " << (e.orden == 2 ? "ascendente" : "normal")
+       << ", testores " << cantidad << ", " << fixed << setprecision(3) << ms << " ms\n";
+    t += os.str();
+
+    if (con_testores)
+        for (auto& C : testores) {
+            for (int j = 0; j < columnas; ++j) {
+                t += char('0' + ((C[j >> 6] >> (j & 63)) & 1));
+                t += ' ';
+            }
+            t += '\n';
+        }
+    return true;
+}
+
+// Cola de tareas de un hilo. Se llenan en orden de costo decreciente, asi
+// que el dueno toma por delante la mas cara que le queda y un hilo sin
+// trabajo roba por detras de la cola con mas costo pendiente.
+struct ColaLote {
+    mutex m;
+    deque<size_t> tareas;
+    double costo = 0;
+};
+
+// Reparte las entradas entre 'hilos' hilos (0 = todos los nucleos) y
+// escribe los bloques en 'out' en el orden del manifiesto.
+InfoLote ejecutar_lote(const vector<EntradaLote>& entradas, ostream& out,
+                       int hilos, bool con_testores) {
+    InfoLote info;
+    size_t n = entradas.size();
+    info.matrices = n;
+    if (hilos <= 0) hilos = max(1u, thread::hardware_concurrency());
+    hilos = max<size_t>(1, min<size_t>(hilos, n));
+
+    vector<size_t> orden(n);
+    iota(orden.begin(), orden.end(), 0);
+    stable_sort(orden.begin(), orden.end(),
+                [&](size_t a, size_t b) { return entradas[a].costo > entradas[b].costo; });
+
+    // Reparto inicial por turnos: cada cola queda tambien ordenada por costo
+    vector<ColaLote> colas(hilos);
+    for (size_t k = 0; k < n; ++k) {
+        ColaLote& c = colas[k % hilos];
+        c.tareas.push_back(orden[k]);
+        c.costo += entradas[orden[k]].costo;
+    }
+
+    SalidaLote salida(out, n);
+    info.tareas_por_hilo.assign(hilos, 0);
+    info.robadas_por_hilo.assign(hilos, 0);
+    atomic<size_t> fallidas{0}, testores{0};
+
+    auto tomar = [&](int yo, size_t& tarea) {
+        {
+            ColaLote& c = colas[yo];
+            lock_guard<mutex> lk(c.m);
+            if (!c.tareas.empty()) {
+                tarea = c.tareas.front();
+                c.tareas.pop_front();
+                c.costo -= entradas[tarea].costo;
+                return true;
+            }
+        }
+        // Las colas solo se vacian, asi que si todas estan vacias no queda nada
+        while (true) {
+            int victima = -1;
+            double mayor = 0;
+            for (int k = 0; k < hilos; ++k) {
+                lock_guard<mutex> lk(colas[k].m);
+                if (!colas[k].tareas.empty() && colas[k].costo > mayor) {
+                    mayor = colas[k].costo;
+                    victima = k;
+                }
+            }
+            if (victima < 0) return false;
+            ColaLote& c = colas[victima];
+            lock_guard<mutex> lk(c.m);
+            if (c.tareas.empty()) continue;
+            tarea = c.tareas.back();
+            c.tareas.pop_back();
+            c.costo -= entradas[tarea].costo;
+            info.robadas_por_hilo[yo]++;
+            return true;
+        }
+    };
+
+    auto trabajar = [&](int yo) {
+        ArenaLote arena;
+        size_t tarea, cantidad;
+        while (tomar(yo, tarea)) {
+            if (!resolver_entrada(entradas[tarea], tarea, con_testores, arena, cantidad))
+                fallidas++;
+            testores += cantidad;
+            info.tareas_por_hilo[yo]++;
+            salida.entregar(tarea, arena.texto);
+        }
+    };
+
+    auto inicio = chrono::high_resolution_clock::now();
+    vector<thread> pool;
+    for (int k = 1; k < hilos; ++k) pool.emplace_back(trabajar, k);
+    trabajar(0);
+    for (auto& t : pool) t.join();
+    out.flush();
+    info.ms = chrono::duration<double, milli>(chrono::high_resolution_clock::now() - inicio).count();
+
+    info.fallidas = fallidas;
+    info.testores = testores;
+    return info;
+}
+
+// Lee el manifiesto, resuelve el lote y escribe en 'ruta_salida' ('-' =
+// pantalla). Devuelve 0 si todas las matrices se resolvieron.
+int procesar_lote(const string& manifiesto, const string& ruta_salida, int hilos, bool con_testores) {
+    vector<EntradaLote> entradas;
+    if (!leer_manifiesto(manifiesto, entradas)) {
+        cerr << "Error: el manifiesto no tiene entradas validas.\n";
+        return 1;
+    }
+
+    ofstream archivo;
+    if (ruta_salida != "-") {
+        archivo.open(ruta_salida, ios::trunc);
+        if (!archivo) {
+            cerr << "Error: no se pudo crear " << ruta_salida << "\n";
+            return 1;
+        }
+    }
+    ostream& out = (ruta_salida == "-") ? cout : archivo;
+
+    InfoLote info = ejecutar_lote(entradas, out, hilos, con_testores);
+
+    cout << "\nMatrices: " << info.matrices << " (fallidas: " << info.fallidas << ")"
+         << ", testores: " << info.testores << "\n";
+    cout << "Tiempo total: " << fixed << setprecision(3) << info.ms << " ms, "
+         << setprecision(1) << 1000.0 * info.matrices / max(info.ms, 1e-3) << " matrices/s\n";
+    cout << "Tareas por hilo (robadas):";
+    for (size_t k = 0; k < info.tareas_por_hilo.size(); ++k)
+        cout << " " << info.tareas_por_hilo[k] << " (" << info.robadas_por_hilo[k] << ")";
+    cout << "\n";
+    if (ruta_salida != "-") cout << "Resultados en: " << ruta_salida << "\n";
+    return info.fallidas == 0 ? 0 : 1;
+}
+
+// Resultado de una busqueda con presupuesto: completa o parcial
+void mostrar_busqueda(const vector<ConjuntoBits>& res, int columnas, int alg,
+                      const InfoBusqueda& info, const OpcionesBusqueda& op) {
+    if (info.completa) {
+        cout << (alg == 1 ? "\nTestores YYC:\n" : "\nTestores BT:\n");
+        imprimir_testores(res, columnas);
+        cout << "Cantidad: " << res.size() << "\n";
+    } else {
+        cout << "\nBusqueda detenida por presupuesto. Espacio cubierto: "
+             << fixed << setprecision(2) << 100.0 * info.cobertura << " %\n";
+        cout << (alg == 1 ? "Activos tras la ultima fila completa (parcial):\n"
+                          : "Testores BT hallados hasta ahora (parcial):\n");
+        imprimir_testores(res, columnas);
+        cout << "Cantidad parcial: " << res.size() << "\n";
+        if (!op.checkpoint.empty())
+            cout << "Checkpoint guardado en: " << op.checkpoint << " (opcion 8 para reanudar)\n";
+    }
+    cout << "Nodos evaluados: " << info.nodos << "\n";
+    cout << "Tiempo acumulado: " << fixed << setprecision(3) << info.ms << " ms\n";
+}
+
+// Pide presupuesto y archivo de checkpoint; '-' o 0 significan sin limite
+OpcionesBusqueda leer_opciones_busqueda() {
+    OpcionesBusqueda op;
+    double seg;
+    cout << "Presupuesto de tiempo en segundos (0 = sin limite): ";
+    cin >> seg;
+    op.presupuesto_ms = seg * 1000;
+    cout << "Presupuesto de nodos (0 = sin limite): ";
+    cin >> op.presupuesto_nodos;
+    cout << "Archivo de checkpoint ('-' = ninguno): ";
+    cin >> op.checkpoint;
+    if (op.checkpoint == "-") op.checkpoint.clear();
+    return op;
+}
+
+// Con TESTORES_SIN_MAIN el archivo se puede incluir desde otro programa
+// (por ejemplo microbench.cpp) sin arrastrar el menu.
+#ifndef TESTORES_SIN_MAIN
+int main(int argc, char* argv[]) {
+    if (argc > 0) ruta_programa = argv[0];
+    error_code ec;
+    if (filesystem::exists("/proc/self/exe", ec))
+        ruta_programa = filesystem::read_symlink("/proc/self/exe", ec).string();
+    if (argc > 1 && string(argv[1]) == "--trabajador")
+        return modo_trabajador();
+    if (argc > 2 && string(argv[1]) == "--lote") {
+        int r = procesar_lote(argv[2], argc > 3 ? argv[3] : "-", argc > 4 ? atoi(argv[4]) : 0, true);
+        reportar_perfil();
+        return r;
+    }
+    if (argc > 2 && string(argv[1]) == "--bin-a-texto") {
+        ofstream archivo;
+        if (argc > 3) archivo.open(argv[3], ios::trunc);
+        if (argc > 3 && !archivo) {
+            cerr << "Error: no se pudo crear " << argv[3] << "\n";
+            return 1;
+        }
+        return bin_a_texto(argv[2], argc > 3 ? archivo : cout) < 0 ? 1 : 0;
+    }
+
+    Matriz M, MB, ultimaGeneradaPotenciada;
+    int op;
+
+    while (true) {
+        reportar_perfil();
+        cout << "\n================ MENU PRINCIPAL ================\n";
         cout << "1) Generar matriz aleatoria y aplicar algoritmo\n";
         cout << "2) Usar Matriz A y aplicar algoritmo\n";
         cout << "3) Usar Matriz B y aplicar algoritmo\n";
         cout << "4) Operadores entre A y B\n";
         cout << "5) phi^n o gamma^n desde theta(A,B)\n";
         cout << "6) Aplicar YYC o BT sobre ultima generada\n";
+        cout << "7) YYC o BT con presupuesto y checkpoints\n";
+        cout << "8) Reanudar busqueda desde checkpoint\n";
+        cout << "9) YYC o BT distribuido en varios procesos\n";
+        cout << "10) Construir MB desde una tabla etiquetada (matriz de diferencias)\n";
+        cout << "11) YYC con memoria limitada (frontera en disco)\n";
+        cout << "12) YYC en profundidad (memoria minima, varios hilos)\n";
+        cout << "13) YYC en tuberia (generacion, MB y busqueda a la vez)\n";
+        cout << "14) Procesar un lote de matrices (manifiesto)\n";
+        cout << "15) Testores en formato binario (guardar, convertir, consultar)\n";
         cout << "0) Salir\n";
         cout << "Ingrese opcion: ";
         cin >> op;
@@ -435,6 +4386,7 @@ int main() {
                 cout << "\nIngrese filas: "; cin >> filas;
                 cout << "Ingrese columnas: "; cin >> columnas;
 
+                FasePerfil fase("generacion");
                 random_device rd;
                 mt19937 gen(rd());
                 bernoulli_distribution dist(0.5);
@@ -480,6 +4432,10 @@ int main() {
             cout << "\nMatriz Basica (MB):\n";
             imprimir_matriz(MB);
             cout << "Densidad: " << densidad(MB) << "\n";
+            if (MB.empty() || MB[0].empty()) {
+                cout << "\nLa matriz basica esta vacia: no hay testores.\n";
+                continue;
+            }
 
             // ------------------ ALGORITMO ------------------
             cout << "\nSeleccione algoritmo:\n1) YYC\n2) BT\nOpcion: ";
@@ -495,28 +4451,21 @@ int main() {
             Matriz MB_usada = (orden == 2) ? ordenar_filas_por_unos(MB) : MB;
 
             if (alg == 1) {
-                auto testores = YYC(MB_usada);
+                auto testores = testores_con_cache(MB, MB_usada, 1, orden);
                 auto end = chrono::high_resolution_clock::now();
                 auto dur = chrono::duration_cast<chrono::milliseconds>(end - start).count();
 
                 cout << "\nTestores YYC:\n";
-                for (auto& C : testores) {
-                    vector<int> bin = conjunto_a_vector_binario(C, MB_usada[0].size());
-                    for (int b : bin) cout << b << " ";
-                    cout << "\n";
-                }
+                imprimir_testores(testores, MB_usada[0].size());
                 cout << "Cantidad: " << testores.size() << "\n";
                 cout << "Tiempo: " << dur << " ms\n";
             } else {
-                auto testores = BT(MB_usada);
+                auto testores = testores_con_cache(MB, MB_usada, 2, orden);
                 auto end = chrono::high_resolution_clock::now();
                 auto dur = chrono::duration_cast<chrono::milliseconds>(end - start).count();
 
                 cout << "\nTestores BT:\n";
-                for (auto& fila : testores) {
-                    for (int x : fila) cout << x << " ";
-                    cout << "\n";
-                }
+                imprimir_testores(testores, MB_usada[0].size());
                 cout << "Cantidad: " << testores.size() << "\n";
                 cout << "Tiempo: " << dur << " ms\n";
             }
@@ -554,6 +4503,7 @@ int main() {
 
    		Matriz resultado;
 
+    	FasePerfil fase("generacion");
     	if (opOperador == 1) resultado = theta(MB_A, MB_B);
     	else if (opOperador == 2) resultado = phi(MB_A, MB_B);
     	else if (opOperador == 3) resultado = gamma(MB_A, MB_B);
@@ -561,6 +4511,7 @@ int main() {
         	cout << "Opción invalida.\n";
         	continue;
     	}
+    	fase.terminar();
 
     	cout << "\nMatriz resultado del operador seleccionado:\n";
     	imprimir_matriz(resultado);
@@ -598,15 +4549,20 @@ int main() {
     		cout << "Ingrese el valor de n (potencia del operador): ";
     		int n;
     		cin >> n;
+    		if (n < 0 || n > 30) {
+    			cout << "\nn debe estar entre 0 y 30.\n";
+    			continue;
+    		}
 
+    		// Se construye directamente al tamano final, sin las n copias intermedias
+    		FasePerfil fase("generacion");
     		Matriz resultado = base;
-
-    		for (int i = 1; i <= n; ++i) {
-        		if (opOp == 1)
-            		resultado = phi(resultado, resultado);
-        		else if (opOp == 2)
-            		resultado = gamma(resultado, resultado);
-    		}
+    		if (opOp == 1)
+        		resultado = phi_n(base, n);
+    		else if (opOp == 2)
+        		resultado = gamma_n(base, n);
+    		fase.terminar();
+    		if (resultado.empty()) continue;   // demasiado grande; ya se aviso
 
     		cout << "\nResultado final del operador aplicado " << n << " veces:\n";
     		imprimir_matriz(resultado);
@@ -663,32 +4619,25 @@ int main() {
     		Matriz MB_usada = (orden == 2) ? ordenar_filas_por_unos(MB) : MB;
 
     		if (alg == 1) {
-        		auto testores = YYC(MB_usada);
+        		auto testores = testores_con_cache(MB, MB_usada, 1, orden);
 
         		auto end = std::chrono::high_resolution_clock::now();
         		auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
 
         		cout << "Testores YYC:\n";
-        		for (auto& C : testores) {
-            		vector<int> bin = conjunto_a_vector_binario(C, MB_usada[0].size());
-            		for (int b : bin) cout << b << " ";
-            		cout << "\n";
-        		}
+        		imprimir_testores(testores, MB_usada[0].size());
 
         		cout << "Número de testores típicos encontrados: " << testores.size() << "\n";
         		cout << "Tiempo de ejecución total: " << duration << " ms\n";
 
     	} else if (alg == 2) {
-        	auto testores = BT(MB_usada);
+        	auto testores = testores_con_cache(MB, MB_usada, 2, orden);
 
         	auto end = std::chrono::high_resolution_clock::now();
         	auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
 
         	cout << "Testores BT:\n";
-        	for (auto& fila : testores) {
-           		for (int x : fila) cout << x << " ";
-            	cout << "\n";
-        	}
+        	imprimir_testores(testores, MB_usada[0].size());
 
         		cout << "Número de testores típicos encontrados: " << testores.size() << "\n";
         		cout << "Tiempo de ejecución total: " << duration << " ms\n";
@@ -696,6 +4645,391 @@ int main() {
     }
 }
 
+        // ------------------------------------------------------
+        // 7. Busqueda con presupuesto y checkpoints
+        // ------------------------------------------------------
+        else if (op == 7) {
+            cout << "\nMatriz:\n1) Ultima MB (opciones 1-3 o 10)\n2) Ultima generada (opcion 5)\nOpcion: ";
+            int fuente;
+            cin >> fuente;
+
+            Matriz base = (fuente == 2) ? aMatrizBasica(ultimaGeneradaPotenciada) : MB;
+            if (base.empty()) {
+                cout << "\nNo hay matriz basica disponible.\n";
+                continue;
+            }
+
+            cout << "\nSeleccione algoritmo:\n1) YYC\n2) BT\nOpcion: ";
+            int alg;
+            cin >> alg;
+            cout << "\nOrdenamiento:\n1) Normal\n2) Ascendente por unos\nOpcion: ";
+            int orden;
+            cin >> orden;
+
+            OpcionesBusqueda opciones = leer_opciones_busqueda();
+            Matriz MB_usada = (orden == 2) ? ordenar_filas_por_unos(base) : base;
+
+            InfoBusqueda info;
+            auto res = (alg == 1) ? YYC_rapido(MB_usada, opciones, &info)
+                                  : BT_rapido(MB_usada, opciones, &info);
+            mostrar_busqueda(res, MB_usada[0].size(), alg == 1 ? 1 : 2, info, opciones);
+            continue;
+        }
+
+        // ------------------------------------------------------
+        // 8. Reanudar desde checkpoint
+        // ------------------------------------------------------
+        else if (op == 8) {
+            string ruta;
+            cout << "\nArchivo de checkpoint: ";
+            cin >> ruta;
+
+            Checkpoint c;
+            if (!cargar_checkpoint(ruta, c)) {
+                cout << "\nNo se pudo leer el checkpoint.\n";
+                continue;
+            }
+            OpcionesBusqueda opciones = leer_opciones_busqueda();
+
+            InfoBusqueda info;
+            int columnas;
+            auto res = reanudar_busqueda(ruta, opciones, info, columnas);
+            if (columnas > 0) mostrar_busqueda(res, columnas, c.alg, info, opciones);
+            continue;
+        }
+
+        // ------------------------------------------------------
+        // 9. Busqueda distribuida
+        // ------------------------------------------------------
+        else if (op == 9) {
+            cout << "\nMatriz:\n1) Ultima MB (opciones 1-3 o 10)\n2) Ultima generada (opcion 5)\nOpcion: ";
+            int fuente;
+            cin >> fuente;
+
+            Matriz base = (fuente == 2) ? aMatrizBasica(ultimaGeneradaPotenciada) : MB;
+            if (base.empty()) {
+                cout << "\nNo hay matriz basica disponible.\n";
+                continue;
+            }
+
+            cout << "\nSeleccione algoritmo:\n1) YYC\n2) BT\nOpcion: ";
+            int alg;
+            cin >> alg;
+            cout << "\nOrdenamiento:\n1) Normal\n2) Ascendente por unos\nOpcion: ";
+            int orden;
+            cin >> orden;
+            cout << "Numero de procesos trabajadores: ";
+            int procesos;
+            cin >> procesos;
+            procesos = max(1, procesos);
+
+            Matriz MB_usada = (orden == 2) ? ordenar_filas_por_unos(base) : base;
+
+            auto start = chrono::high_resolution_clock::now();
+            vector<ConjuntoBits> testores;
+            if (alg == 1) {
+                // Frontera tras la primera tercera parte de las filas, en
+                // unos 8 fragmentos por proceso
+                int k = max(1, (int)MB_usada.size() / 3);
+                testores = YYC_distribuido(MB_usada, procesos, k, 8 * procesos);
+            } else {
+                int bits = 0;
+                while ((1 << bits) < 8 * procesos) bits++;
+                testores = BT_distribuido(MB_usada, procesos, bits);
+            }
+            auto end = chrono::high_resolution_clock::now();
+            auto dur = chrono::duration_cast<chrono::milliseconds>(end - start).count();
+
+            cout << (alg == 1 ? "\nTestores YYC:\n" : "\nTestores BT:\n");
+            imprimir_testores(testores, MB_usada[0].size());
+            cout << "Cantidad: " << testores.size() << "\n";
+            cout << "Tiempo: " << dur << " ms\n";
+            continue;
+        }
+
+        // ------------------------------------------------------
+        // 10. MB desde tabla etiquetada
+        // ------------------------------------------------------
+        else if (op == 10) {
+            string ruta;
+            cout << "\nArchivo de la tabla (rasgos... clase por linea): ";
+            cin >> ruta;
+
+            TablaEtiquetada T;
+            if (!leer_tabla_etiquetada(ruta, T)) {
+                cout << "\nNo se pudo leer la tabla.\n";
+                continue;
+            }
+
+            auto start = chrono::high_resolution_clock::now();
+            long long pares = 0, identicos = 0;
+            FasePerfil fase("generacion");
+            MatrizBits MBb = matriz_basica_desde_tabla(T, &pares, &identicos);
+            fase.terminar();
+            auto end = chrono::high_resolution_clock::now();
+            auto dur = chrono::duration_cast<chrono::milliseconds>(end - start).count();
+
+            cout << "\nObjetos: " << T.objetos << ", rasgos: " << T.rasgos
+                 << ", pares comparados: " << pares << "\n";
+            if (MBb.filas == 0) {
+                cout << "No hay pares de objetos de clases distintas.\n";
+                continue;
+            }
+
+            MB = desempaquetar(MBb);
+            cout << "\nMatriz Basica (MB):\n";
+            imprimir_matriz(MB);
+            cout << "Densidad: " << densidad(MBb) << "\n";
+            cout << "Tiempo: " << dur << " ms\n";
+            if (identicos > 0)
+                cout << "Aviso: pares de objetos identicos de clases distintas: " << identicos
+                     << "; no existen testores.\n";
+            else
+                cout << "Use las opciones 7, 9, 11 o 12 para buscar sus testores.\n";
+            continue;
+        }
+
+        // ------------------------------------------------------
+        // 11. YYC con frontera en disco
+        // ------------------------------------------------------
+        else if (op == 11) {
+            cout << "\nMatriz:\n1) Ultima MB (opciones 1-3 o 10)\n2) Ultima generada (opcion 5)\nOpcion: ";
+            int fuente;
+            cin >> fuente;
+
+            Matriz base = (fuente == 2) ? aMatrizBasica(ultimaGeneradaPotenciada) : MB;
+            if (base.empty()) {
+                cout << "\nNo hay matriz basica disponible.\n";
+                continue;
+            }
+
+            cout << "\nOrdenamiento:\n1) Normal\n2) Ascendente por unos\nOpcion: ";
+            int orden;
+            cin >> orden;
+            cout << "Memoria para la frontera en MB: ";
+            double megas;
+            cin >> megas;
+            cout << "Directorio para las corridas (- = temporal del sistema): ";
+            string dir;
+            cin >> dir;
+            if (dir == "-") dir.clear();
+
+            Matriz MB_usada = (orden == 2) ? ordenar_filas_por_unos(base) : base;
+
+            auto start = chrono::high_resolution_clock::now();
+            InfoDisco info;
+            auto testores = YYC_externo_rapido(MB_usada, size_t(max(1.0, megas) * 1048576), dir, &info);
+            auto end = chrono::high_resolution_clock::now();
+            auto dur = chrono::duration_cast<chrono::milliseconds>(end - start).count();
+
+            cout << "\nTestores YYC:\n";
+            imprimir_testores(testores, MB_usada[0].size());
+            cout << "Cantidad: " << testores.size() << "\n";
+            cout << "Tiempo: " << dur << " ms\n";
+            cout << "Frontera maxima: " << info.pico_frontera << " candidatos, filas en disco: "
+                 << info.filas_en_disco << ", corridas: " << info.corridas << "\n";
+            cout << "Escrito: " << fixed << setprecision(2) << info.bytes_escritos / 1048576.0
+                 << " MB, leido: " << info.bytes_leidos / 1048576.0 << " MB\n";
+            continue;
+        }
+
+        // ------------------------------------------------------
+        // 12. YYC en profundidad
+        // ------------------------------------------------------
+        else if (op == 12) {
+            cout << "\nMatriz:\n1) Ultima MB (opciones 1-3 o 10)\n2) Ultima generada (opcion 5)\nOpcion: ";
+            int fuente;
+            cin >> fuente;
+
+            Matriz base = (fuente == 2) ? aMatrizBasica(ultimaGeneradaPotenciada) : MB;
+            if (base.empty()) {
+                cout << "\nNo hay matriz basica disponible.\n";
+                continue;
+            }
+
+            cout << "\nOrdenamiento:\n1) Normal\n2) Ascendente por unos\nOpcion: ";
+            int orden;
+            cin >> orden;
+            cout << "Numero de hilos (0 = todos los nucleos): ";
+            int hilos;
+            cin >> hilos;
+
+            Matriz MB_usada = (orden == 2) ? ordenar_filas_por_unos(base) : base;
+
+            auto start = chrono::high_resolution_clock::now();
+            auto testores = YYC_profundidad_rapido(MB_usada, hilos);
+            auto end = chrono::high_resolution_clock::now();
+            auto dur = chrono::duration_cast<chrono::milliseconds>(end - start).count();
+
+            cout << "\nTestores YYC:\n";
+            imprimir_testores(testores, MB_usada[0].size());
+            cout << "Cantidad: " << testores.size() << "\n";
+            cout << "Tiempo: " << dur << " ms\n";
+            continue;
+        }
+
+        // ------------------------------------------------------
+        // 13. YYC en tuberia
+        // ------------------------------------------------------
+        else if (op == 13) {
+            cout << "\nMatriz:\n1) Aleatoria\n2) Ultima generada (opcion 5)\nOpcion: ";
+            int fuente;
+            cin >> fuente;
+
+            int filas, columnas;
+            if (fuente == 2) {
+                if (ultimaGeneradaPotenciada.empty()) {
+                    cout << "\nNo hay una matriz generada aun. Usa la opcion 5 primero.\n";
+                    continue;
+                }
+                filas = ultimaGeneradaPotenciada.size();
+                columnas = ultimaGeneradaPotenciada[0].size();
+            } else {
+                cout << "\nIngrese filas: "; cin >> filas;
+                cout << "Ingrese columnas: "; cin >> columnas;
+                if (filas < 1 || columnas < 1) {
+                    cout << "\nDimensiones invalidas.\n";
+                    continue;
+                }
+            }
+            cout << "Mostrar la matriz generada (1 = si, 0 = no): ";
+            int mostrar;
+            cin >> mostrar;
+            cout << "Verificar contra aMatrizBasica + YYC secuencial (1 = si, 0 = no): ";
+            int verificar;
+            cin >> verificar;
+
+            // Solo si se verifica hace falta guardar M completa
+            random_device rd;
+            mt19937 gen(rd());
+            bernoulli_distribution dist(0.5);
+            Matriz generada;
+            auto generar = [&](int i, vector<uint64_t>& r) {
+                for (int j = 0; j < columnas; ++j) {
+                    int v = (fuente == 2) ? ultimaGeneradaPotenciada[i][j] : dist(gen);
+                    if (v) r[j >> 6] |= 1ULL << (j & 63);
+                }
+                if (verificar) generada.push_back(bits_a_vector_binario(r, columnas));
+            };
+
+            if (mostrar) cout << "\nMatriz generada:\n";
+            ResultadoTuberia R = YYC_tuberia_rapido(filas, columnas, generar, mostrar == 1);
+
+            cout << "Cantidad: " << R.testores.size() << "\n";
+            cout << "Filas generadas: " << R.generadas << ", filas de MB: " << R.MB.size()
+                 << ", desalojadas: " << R.desalojadas << ", reinicios de YYC: " << R.reinicios << "\n";
+            cout << fixed << setprecision(3)
+                 << "Fin de etapas (ms): generador " << R.fin_generador << ", filtro " << R.fin_filtro
+                 << ", YYC " << R.fin_yyc << ", salida " << R.fin_salida << "\n";
+
+            if (verificar) {
+                Matriz MB_ref = aMatrizBasica(generada);
+                streambuf* viejo = cout.rdbuf(nullptr);
+                auto ref = YYC_rapido(MB_ref);
+                cout.rdbuf(viejo);
+                bool igual = MB_ref == R.MB && ref == R.testores;
+                cout << "Verificacion: " << (igual ? "coincide" : "NO coincide")
+                     << " con aMatrizBasica + YYC secuencial\n";
+            }
+            MB = R.MB;
+            continue;
+        }
+
+        else if (op == 14) {
+            string manifiesto, salida;
+            cout << "\nArchivo de manifiesto: ";
+            cin >> manifiesto;
+            cout << "Archivo de salida ('-' = pantalla): ";
+            cin >> salida;
+            cout << "Hilos (0 = todos los nucleos): ";
+            int hilos;
+            cin >> hilos;
+            cout << "Incluir los testores en la salida (1 = si, 0 = solo cantidades): ";
+            int con_testores;
+            cin >> con_testores;
+
+            procesar_lote(manifiesto, salida, hilos, con_testores == 1);
+            continue;
+        }
+
+        else if (op == 15) {
+            cout << "\n1) Guardar los testores de la MB actual\n2) Convertir un archivo binario a texto\n"
+                 << "3) Consultar un archivo binario\nOpcion: ";
+            int sub;
+            cin >> sub;
+
+            if (sub == 1) {
+                if (MB.empty()) {
+                    cout << "\nNo hay una MB calculada. Usa primero las opciones 1-3, 10 o 13.\n";
+                    continue;
+                }
+                cout << "\nSeleccione algoritmo:\n1) YYC\n2) BT\nOpcion: ";
+                int alg;
+                cin >> alg;
+                cout << "Archivo de salida: ";
+                string ruta;
+                cin >> ruta;
+
+                auto testores = testores_con_cache(MB, MB, alg, 1);
+                int columnas = MB[0].size();
+                if (!guardar_testores_bin(ruta, testores, columnas, empaquetar(MB))) continue;
+                error_code ec;
+                auto bytes = filesystem::file_size(ruta, ec);
+                cout << "\nTestores guardados: " << testores.size() << " en " << ruta << "\n";
+                cout << "Bytes: " << bytes << " (en texto serian "
+                     << testores.size() * (2 * columnas + 1) << ")\n";
+            }
+            else if (sub == 2) {
+                string ruta, salida;
+                cout << "\nArchivo binario: ";
+                cin >> ruta;
+                cout << "Archivo de texto ('-' = pantalla): ";
+                cin >> salida;
+
+                ofstream archivo;
+                if (salida != "-") {
+                    archivo.open(salida, ios::trunc);
+                    if (!archivo) {
+                        cerr << "Error: no se pudo crear " << salida << "\n";
+                        continue;
+                    }
+                }
+                long long n = bin_a_texto(ruta, salida == "-" ? cout : archivo);
+                if (n >= 0) cout << "Testores convertidos: " << n << "\n";
+            }
+            else if (sub == 3) {
+                string ruta;
+                cout << "\nArchivo binario: ";
+                cin >> ruta;
+                LectorTestores L;
+                if (!L.abrir(ruta)) continue;
+
+                cout << "Testores: " << L.c.cantidad << ", columnas: " << L.c.columnas
+                     << ", bloques: " << L.c.bloques << "\n";
+                cout << "MB de origen: " << L.c.filas_MB << " filas, huella "
+                     << hex << setw(16) << setfill('0') << L.c.huella << dec << setfill(' ') << "\n";
+                if (!MB.empty()) {
+                    MatrizBits MBb = empaquetar(MB);
+                    bool igual = MBb.columnas == int(L.c.columnas) && MBb.filas == int(L.c.filas_MB) &&
+                                 huella_matriz(MBb) == L.c.huella;
+                    cout << "MB actual: " << (igual ? "coincide" : "no coincide") << "\n";
+                }
+
+                cout << "Posicion del testor a mostrar (1.." << L.c.cantidad << ", 0 = ninguno): ";
+                long long i;
+                cin >> i;
+                ConjuntoBits t;
+                if (i >= 1 && L.leer(i - 1, t)) {
+                    for (int b : bits_a_vector_binario(t, L.c.columnas)) cout << b << " ";
+                    cout << "\n";
+                }
+            }
+            else {
+                cout << "\n Opcion invalida.\n";
+            }
+            continue;
+        }
+
         // ------------------------------------------------------
         // Opción inválida
         // ------------------------------------------------------
@@ -704,6 +5038,8 @@ int main() {
             continue;
         }
     }
+    reportar_perfil();
 	
     return 0;
-}
\ No newline at end of file
+}
+#endif
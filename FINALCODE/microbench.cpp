@@ -0,0 +1,550 @@
+// Microbenchmark de las primitivas de finalcode.cpp
+// Compilar: g++ -O2 -std=c++17 -pthread microbench.cpp -o microbench
+// Ejecutar: ./microbench [--rapido] [--csv]
+//
+// Barre anchos de 8 a 1024 columnas y varias densidades. Para cada
+// primitiva mide la version original sobre vector<int> y las optimizadas
+// (cada nivel SIMD disponible y los motores empaquetados) y reporta:
+//   ns/op   tiempo medio por operacion
+//   Mop/s   operaciones por segundo
+//   Gcel/s  celdas de la matriz (filas x columnas del operando) por segundo
+//   res/op  reservas de memoria por operacion (operator new contado)
+// Antes de medir se comprueba que todas las variantes dan el mismo
+// resultado que la original; si alguna difiere el programa sale con 1.
+
+#define TESTORES_SIN_MAIN
+#include "finalcode.cpp"
+
+#include <atomic>
+#include <new>
+
+// ====================== CONTADOR DE RESERVAS ==========================
+
+static atomic<long long> reservas(0);
+
+// GCC ve malloc/free dentro de new/delete y avisa de un emparejamiento
+// incorrecto que aqui es justamente lo que se quiere.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(size_t n) {
+    reservas.fetch_add(1, memory_order_relaxed);
+    if (void* p = malloc(n ? n : 1)) return p;
+    throw bad_alloc();
+}
+void* operator new[](size_t n) { return operator new(n); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+// ============================ MEDICION ================================
+
+double objetivo_ms = 20;
+bool salida_csv = false;
+volatile uint64_t sumidero;
+
+long long casos = 0, discrepancias = 0;
+
+void comprobar(bool ok, const string& que) {
+    ++casos;
+    if (ok) return;
+    if (++discrepancias <= 20) cerr << "DISCREPANCIA: " << que << "\n";
+}
+
+// Repite 'lote' (que hace 'ops' operaciones) hasta llenar objetivo_ms y
+// escribe una linea de la tabla.
+template<class F>
+void medir(const string& primitiva, const string& variante, int cols, double dens,
+           long long ops, double celdas_por_op, F lote) {
+    sumidero = sumidero + lote();   // calentar caches y reservas perezosas
+
+    long long repeticiones = 0;
+    long long r0 = reservas.load();
+    auto inicio = chrono::high_resolution_clock::now();
+    double ms = 0;
+    uint64_t acc = 0;
+    do {
+        acc += lote();
+        ++repeticiones;
+        ms = chrono::duration<double, milli>(chrono::high_resolution_clock::now() - inicio).count();
+    } while (ms < objetivo_ms);
+    long long r1 = reservas.load();
+    sumidero = sumidero + acc;
+
+    double total = double(ops) * repeticiones;
+    double ns = ms * 1e6 / total;
+    double mops = total / (ms * 1e3);
+    double gcel = total * celdas_por_op / (ms * 1e6);
+    double res = double(r1 - r0) / total;
+
+    if (salida_csv) {
+        cout << primitiva << "," << variante << "," << cols << "," << dens << ","
+             << ns << "," << mops << "," << gcel << "," << res << "\n";
+    } else {
+        cout << left << setw(20) << primitiva << setw(10) << variante << right
+             << setw(6) << cols << setw(6) << fixed << setprecision(2) << dens
+             << setw(12) << setprecision(1) << ns
+             << setw(11) << setprecision(2) << mops
+             << setw(9) << setprecision(3) << gcel
+             << setw(9) << setprecision(2) << res << "\n";
+    }
+}
+
+// ========================= DATOS DE PRUEBA ============================
+
+mt19937 rng(12345);
+
+vector<int> fila_aleatoria(int cols, double dens) {
+    bernoulli_distribution b(dens);
+    vector<int> f(cols);
+    for (int& v : f) v = b(rng);
+    return f;
+}
+
+// Filas sin ceros, como las de una MB
+Matriz matriz_aleatoria(int filas, int cols, double dens) {
+    Matriz M(filas);
+    for (auto& f : M) {
+        f = fila_aleatoria(cols, dens);
+        f[rng() % cols] = 1;
+    }
+    return M;
+}
+
+Conjunto conjunto_aleatorio(int cols, int tam) {
+    Conjunto C;
+    while ((int)C.size() < tam) C.insert(rng() % cols);
+    return C;
+}
+
+vector<uint64_t> empaquetar_conjunto(const Conjunto& C, int cols) {
+    vector<uint64_t> c(palabras_para(cols), 0);
+    for (int j : C) c[j >> 6] |= 1ULL << (j & 63);
+    return c;
+}
+
+Matriz ordenada(Matriz M) {
+    sort(M.begin(), M.end());
+    return M;
+}
+
+// ===================== VERSIONES ORIGINALES ===========================
+
+// es_testor y encontrar_K tal como estaban en BT() antes de empaquetar
+bool es_testor_original(const Matriz& MB, const vector<int>& nuplo) {
+    int ROWS = MB.size(), COLS = MB[0].size();
+    for (int i = 0; i < ROWS; i++) {
+        bool tiene_uno = false;
+        for (int j = 0; j < COLS; j++) {
+            if (nuplo[j] == 1 && MB[i][j] == 1) {
+                tiene_uno = true;
+                break;
+            }
+        }
+        if (!tiene_uno) return false;
+    }
+    return true;
+}
+
+int encontrar_K_original(const Matriz& MB, const vector<int>& nuplo) {
+    int ROWS = MB.size(), COLS = MB[0].size();
+    vector<int> filas_ceros;
+    for (int i = 0; i < ROWS; i++) {
+        bool fila_c = true;
+        for (int j = 0; j < COLS; j++) {
+            if (nuplo[j] == 1 && MB[i][j] == 1) {
+                fila_c = false;
+                break;
+            }
+        }
+        if (fila_c) filas_ceros.push_back(i);
+    }
+
+    int K = COLS + 1;
+    for (int f : filas_ceros) {
+        int ultima_pos = -1;
+        for (int j = COLS - 1; j >= 0; j--) {
+            if (MB[f][j] == 1) {
+                ultima_pos = j + 1;
+                break;
+            }
+        }
+        if (ultima_pos != -1)
+            K = min(K, ultima_pos);
+    }
+    return K;
+}
+
+// aMatrizBasica con esSubfila sobre vector<int>
+Matriz aMatrizBasica_original(const Matriz& M) {
+    Matriz U = filasUnicas(M);
+    int r = U.size();
+
+    vector<char> keep(r, 1);
+    for (int i = 0; i < r; i++)
+        for (int j = 0; j < r; j++)
+            if (i != j && esSubfila(U[i], U[j]))
+                keep[i] = 0;
+
+    Matriz BM;
+    for (int i = 0; i < r; i++)
+        if (keep[i]) BM.push_back(U[i]);
+    return BM;
+}
+
+// Operadores tal como estaban, con una fila nueva y push_back por fila
+Matriz phi_original(const Matriz& A, const Matriz& B) {
+    Matriz resultado;
+    for (size_t i = 0; i < A.size(); ++i) {
+        vector<int> fila = A[i];
+        fila.insert(fila.end(), B[i].begin(), B[i].end());
+        resultado.push_back(fila);
+    }
+    return resultado;
+}
+
+Matriz theta_original(const Matriz& A, const Matriz& B) {
+    Matriz resultado;
+    for (const auto& filaA : A) {
+        for (const auto& filaB : B) {
+            vector<int> fila = filaA;
+            fila.insert(fila.end(), filaB.begin(), filaB.end());
+            resultado.push_back(fila);
+        }
+    }
+    return resultado;
+}
+
+Matriz gamma_original(const Matriz& A, const Matriz& B) {
+    size_t filasA = A.size(), filasB = B.size();
+    size_t colsA = A[0].size(), colsB = B[0].size();
+    Matriz resultado(filasA + filasB, vector<int>(colsA + colsB, 0));
+    for (size_t i = 0; i < filasA; ++i)
+        for (size_t j = 0; j < colsA; ++j)
+            resultado[i][j] = A[i][j];
+    for (size_t i = 0; i < filasB; ++i)
+        for (size_t j = 0; j < colsB; ++j)
+            resultado[filasA + i][colsA + j] = B[i][j];
+    return resultado;
+}
+
+// phi^n y gamma^n repitiendo el operador, como se hacia en el menu
+Matriz phi_n_original(const Matriz& X, int n) {
+    Matriz R = X;
+    for (int k = 0; k < n; ++k) R = phi_original(R, R);
+    return R;
+}
+
+Matriz gamma_n_original(const Matriz& X, int n) {
+    Matriz R = X;
+    for (int k = 0; k < n; ++k) R = gamma_original(R, R);
+    return R;
+}
+
+// ============================ BANCOS ==================================
+
+const int PARES = 1024;
+const int FILAS_MB = 64;
+
+void banco_filas(int cols, double dens) {
+    // Pares (r, s); la mitad con s superconjunto de r para que esSubfila
+    // tenga que recorrer la fila entera.
+    Matriz R(PARES), S(PARES);
+    for (int i = 0; i < PARES; ++i) {
+        R[i] = fila_aleatoria(cols, dens);
+        S[i] = fila_aleatoria(cols, dens);
+        if (i % 2 == 0)
+            for (int j = 0; j < cols; ++j) S[i][j] |= R[i][j];
+    }
+    MatrizBits RB = empaquetar(R), SB = empaquetar(S);
+    int nw = RB.palabras;
+
+    vector<char> ref(PARES);
+    for (int i = 0; i < PARES; ++i) ref[i] = esSubfila(R[i], S[i]);
+    for (auto& K : kernels_disponibles())
+        for (int i = 0; i < PARES; ++i)
+            comprobar(K.es_subfila(RB.fila(i), SB.fila(i), nw) == ref[i],
+                      string("esSubfila ") + K.nombre + " cols=" + to_string(cols));
+
+    // popcount y popcount_and no tienen version original; se comparan con
+    // la cuenta directa sobre las filas sin empaquetar.
+    for (auto& K : kernels_disponibles())
+        for (int i = 0; i < PARES; ++i) {
+            int ambos = 0;
+            for (int j = 0; j < cols; ++j) ambos += R[i][j] & S[i][j];
+            comprobar(K.popcount(RB.fila(i), nw) == contar_unos(R[i]),
+                      string("popcount ") + K.nombre + " cols=" + to_string(cols));
+            comprobar(K.popcount_and(RB.fila(i), SB.fila(i), nw) == ambos,
+                      string("popcount_and ") + K.nombre + " cols=" + to_string(cols));
+        }
+
+    medir("esSubfila", "original", cols, dens, PARES, cols, [&] {
+        uint64_t n = 0;
+        for (int i = 0; i < PARES; ++i) n += esSubfila(R[i], S[i]);
+        return n;
+    });
+    for (auto& K : kernels_disponibles())
+        medir("esSubfila", K.nombre, cols, dens, PARES, cols, [&] {
+            uint64_t n = 0;
+            for (int i = 0; i < PARES; ++i) n += K.es_subfila(RB.fila(i), SB.fila(i), nw);
+            return n;
+        });
+
+    // tiene_uno_en_fila con conjuntos pequenos, como los de YYC; la mitad
+    // tomados de columnas en 0 de la fila para que no corten pronto.
+    vector<Conjunto> C(PARES);
+    for (int i = 0; i < PARES; ++i) {
+        int tam = 1 + rng() % 4;
+        if (i % 2 == 0) {
+            vector<int> ceros;
+            for (int j = 0; j < cols; ++j)
+                if (!R[i][j]) ceros.push_back(j);
+            shuffle(ceros.begin(), ceros.end(), rng);
+            if ((int)ceros.size() > tam) ceros.resize(tam);
+            C[i] = Conjunto(ceros.begin(), ceros.end());
+        }
+        if (C[i].empty()) C[i] = conjunto_aleatorio(cols, min(tam, cols));
+    }
+    MatrizBits PB;
+    PB.filas = PARES;
+    PB.columnas = cols;
+    PB.palabras = nw;
+    for (auto& c : C) {
+        vector<uint64_t> p = empaquetar_conjunto(c, cols);
+        PB.datos.insert(PB.datos.end(), p.begin(), p.end());
+    }
+
+    for (int i = 0; i < PARES; ++i) ref[i] = tiene_uno_en_fila(R[i], C[i]);
+    for (auto& K : kernels_disponibles())
+        for (int i = 0; i < PARES; ++i)
+            comprobar(K.interseca(RB.fila(i), PB.fila(i), nw) == ref[i],
+                      string("tiene_uno_en_fila ") + K.nombre + " cols=" + to_string(cols));
+
+    medir("tiene_uno_en_fila", "original", cols, dens, PARES, cols, [&] {
+        uint64_t n = 0;
+        for (int i = 0; i < PARES; ++i) n += tiene_uno_en_fila(R[i], C[i]);
+        return n;
+    });
+    for (auto& K : kernels_disponibles())
+        medir("tiene_uno_en_fila", K.nombre, cols, dens, PARES, cols, [&] {
+            uint64_t n = 0;
+            for (int i = 0; i < PARES; ++i) n += K.interseca(RB.fila(i), PB.fila(i), nw);
+            return n;
+        });
+}
+
+// cumple_criterios, es_testor y encontrar_K sobre una MB de FILAS_MB filas
+template<int N>
+void banco_motor(int cols, double dens) {
+    typedef typename MotorBits<N>::Cand Cand;
+    Matriz MB = matriz_aleatoria(FILAS_MB, cols, dens);
+    MotorBits<N> E(MB);
+    MatrizBits MBb = empaquetar(MB);
+    const int CANDS = 256;
+    double celdas = double(FILAS_MB) * cols;
+    string motor = "motor" + to_string(N ? N : palabras_para(cols));
+
+    // YYC: extensiones de 1 a 4 columnas
+    vector<Conjunto> C(CANDS);
+    vector<Cand> CE(CANDS);
+    for (int i = 0; i < CANDS; ++i) {
+        C[i] = conjunto_aleatorio(cols, min(cols, 1 + int(rng() % 4)));
+        CE[i] = E.importar(empaquetar_conjunto(C[i], cols));
+    }
+    vector<uint64_t> uno, dos;
+    for (int i = 0; i < CANDS; ++i)
+        comprobar(E.cumple_criterios(CE[i], FILAS_MB - 1, uno, dos) ==
+                      cumple_criterios(MB, C[i], FILAS_MB - 1),
+                  "cumple_criterios " + motor + " cols=" + to_string(cols));
+
+    medir("cumple_criterios", "original", cols, dens, CANDS, celdas, [&] {
+        uint64_t n = 0;
+        for (int i = 0; i < CANDS; ++i) n += cumple_criterios(MB, C[i], FILAS_MB - 1);
+        return n;
+    });
+    medir("cumple_criterios", motor, cols, dens, CANDS, celdas, [&] {
+        uint64_t n = 0;
+        for (int i = 0; i < CANDS; ++i) n += E.cumple_criterios(CE[i], FILAS_MB - 1, uno, dos);
+        return n;
+    });
+
+    // BT: n-uplos con densidad suficiente para que parte sean testores
+    double q = min(0.9, 2.0 / (dens * cols) + 0.05);
+    vector<vector<int>> B(CANDS);
+    vector<ConjuntoBits> BP(CANDS);
+    vector<Cand> BE(CANDS);
+    for (int i = 0; i < CANDS; ++i) {
+        B[i] = fila_aleatoria(cols, i % 2 ? q : min(0.95, 4 * q));
+        BP[i] = empaquetar_fila(B[i]);
+        BE[i] = E.importar(BP[i]);
+    }
+    // Lo que hace BT() sobre vector<int>: un n-uplo empaquetado contra MB
+    const KernelsBits& K = kernels();
+    auto es_testor_kernels = [&](int i) {
+        return K.cubre_filas(MBb.datos.data(), FILAS_MB, MBb.palabras, BP[i].data());
+    };
+    vector<uint64_t> cubiertas;
+    for (int i = 0; i < CANDS; ++i) {
+        bool t = es_testor_original(MB, B[i]);
+        comprobar(es_testor_kernels(i) == t, string("es_testor ") + K.nombre + " cols=" + to_string(cols));
+        comprobar(E.es_testor(BE[i], cubiertas) == t,
+                  "es_testor " + motor + " cols=" + to_string(cols));
+        if (!t)
+            comprobar(E.encontrar_K(cubiertas) == encontrar_K_original(MB, B[i]),
+                      "encontrar_K " + motor + " cols=" + to_string(cols));
+    }
+
+    medir("BT es_testor", "original", cols, dens, CANDS, celdas, [&] {
+        uint64_t n = 0;
+        for (int i = 0; i < CANDS; ++i) n += es_testor_original(MB, B[i]);
+        return n;
+    });
+    medir("BT es_testor", K.nombre, cols, dens, CANDS, celdas, [&] {
+        uint64_t n = 0;
+        for (int i = 0; i < CANDS; ++i) n += es_testor_kernels(i);
+        return n;
+    });
+    medir("BT es_testor", motor, cols, dens, CANDS, celdas, [&] {
+        uint64_t n = 0;
+        for (int i = 0; i < CANDS; ++i) n += E.es_testor(BE[i], cubiertas);
+        return n;
+    });
+    medir("BT encontrar_K", "original", cols, dens, CANDS, celdas, [&] {
+        uint64_t n = 0;
+        for (int i = 0; i < CANDS; ++i) n += encontrar_K_original(MB, B[i]);
+        return n;
+    });
+    // En BT_bits encontrar_K reutiliza las filas cubiertas de es_testor;
+    // aqui se mide el par completo para no contar un trabajo a medias.
+    medir("BT encontrar_K", motor, cols, dens, CANDS, celdas, [&] {
+        uint64_t n = 0;
+        for (int i = 0; i < CANDS; ++i) {
+            E.es_testor(BE[i], cubiertas);
+            n += E.encontrar_K(cubiertas);
+        }
+        return n;
+    });
+}
+
+void banco_motor_ancho(int cols, double dens) {
+    if (cols <= 64) banco_motor<1>(cols, dens);
+    else if (cols <= 128) banco_motor<2>(cols, dens);
+    else if (cols <= 256) banco_motor<4>(cols, dens);
+    else if (cols <= 512) banco_motor<8>(cols, dens);
+    else banco_motor<0>(cols, dens);
+}
+
+void banco_matrices(int cols, double dens) {
+    // filasUnicas y aMatrizBasica sobre 128 filas con repeticiones
+    const int FILAS = 128;
+    Matriz base = matriz_aleatoria(FILAS / 2, cols, dens);
+    Matriz M;
+    for (int i = 0; i < FILAS; ++i) M.push_back(base[rng() % base.size()]);
+    // Algunas subfilas estrictas para que haya filas que quitar
+    for (int i = 0; i < FILAS / 8; ++i) {
+        vector<int> f = M[rng() % M.size()];
+        for (int j = 0; j < cols; ++j)
+            if (f[j] && rng() % 2) f[j] = 0;
+        f[0] = 1;
+        M.push_back(f);
+    }
+    double celdas = double(M.size()) * cols;
+
+    medir("filasUnicas", "original", cols, dens, 1, celdas, [&] {
+        return uint64_t(filasUnicas(M).size());
+    });
+
+    Matriz ref = ordenada(aMatrizBasica_original(M));
+    comprobar(ordenada(aMatrizBasica(M)) == ref, "aMatrizBasica cols=" + to_string(cols));
+    MatrizBits MBits = empaquetar(M);
+    auto con_filtro = [&] {
+        FiltroDominancia F(cols);
+        for (int i = 0; i < MBits.filas; ++i) F.insertar(MBits.fila(i));
+        return F.matriz();
+    };
+    comprobar(ordenada(desempaquetar(con_filtro())) == ref, "FiltroDominancia cols=" + to_string(cols));
+
+    // Criterio invertido: las filas unicas sin subfila estricta
+    Matriz U = filasUnicas(M), minimales;
+    for (auto& f : U)
+        if (none_of(U.begin(), U.end(), [&](const vector<int>& g) { return esSubfila(g, f); }))
+            minimales.push_back(f);
+    FiltroDominancia Fmin(cols, true);
+    for (int i = 0; i < MBits.filas; ++i) Fmin.insertar(MBits.fila(i));
+    comprobar(ordenada(desempaquetar(Fmin.matriz())) == ordenada(minimales),
+              "FiltroDominancia minimales cols=" + to_string(cols));
+
+    medir("aMatrizBasica", "original", cols, dens, 1, celdas, [&] {
+        return uint64_t(aMatrizBasica_original(M).size());
+    });
+    medir("aMatrizBasica", kernels().nombre, cols, dens, 1, celdas, [&] {
+        return uint64_t(aMatrizBasica(M).size());
+    });
+    medir("aMatrizBasica", "filtro", cols, dens, 1, celdas, [&] {
+        return uint64_t(con_filtro().filas);
+    });
+
+    // Operadores: A y B de 32 filas y cols/2 columnas (el resultado de phi
+    // y gamma tiene 'cols' columnas). Se mide la construccion.
+    int mitad = max(1, cols / 2);
+    Matriz A = matriz_aleatoria(32, mitad, dens), B = matriz_aleatoria(32, mitad, dens);
+
+    comprobar(phi(A, B) == phi_original(A, B), "phi cols=" + to_string(cols));
+    comprobar(theta(A, B) == theta_original(A, B), "theta cols=" + to_string(cols));
+    comprobar(gamma(A, B) == gamma_original(A, B), "gamma cols=" + to_string(cols));
+    for (int n = 0; n <= 2; ++n) {
+        comprobar(phi_n(A, n) == phi_n_original(A, n), "phi^n cols=" + to_string(cols));
+        comprobar(gamma_n(A, n) == gamma_n_original(A, n), "gamma^n cols=" + to_string(cols));
+    }
+
+    double cphi = 32.0 * 2 * mitad, ctheta = 32.0 * 32 * 2 * mitad, cgamma = 64.0 * 2 * mitad;
+    medir("phi", "original", cols, dens, 1, cphi, [&] { return uint64_t(phi_original(A, B).size()); });
+    medir("phi", "directa", cols, dens, 1, cphi, [&] { return uint64_t(phi(A, B).size()); });
+    medir("theta", "original", cols, dens, 1, ctheta, [&] { return uint64_t(theta_original(A, B).size()); });
+    medir("theta", "directa", cols, dens, 1, ctheta, [&] { return uint64_t(theta(A, B).size()); });
+    medir("gamma", "original", cols, dens, 1, cgamma, [&] { return uint64_t(gamma_original(A, B).size()); });
+    medir("gamma", "directa", cols, dens, 1, cgamma, [&] { return uint64_t(gamma(A, B).size()); });
+}
+
+int main(int argc, char* argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        string a = argv[i];
+        if (a == "--rapido") objetivo_ms = 2;
+        else if (a == "--csv") salida_csv = true;
+        else {
+            cerr << "Uso: " << argv[0] << " [--rapido] [--csv]\n";
+            return 2;
+        }
+    }
+
+    const int anchos[] = {8, 16, 32, 64, 128, 256, 512, 1024};
+    const double densidades[] = {0.1, 0.3, 0.5};
+
+    if (salida_csv) {
+        cout << "primitiva,variante,cols,dens,ns_op,mops,gceldas_s,reservas_op\n";
+    } else {
+        cout << "Kernels disponibles:";
+        for (auto& K : kernels_disponibles()) cout << " " << K.nombre;
+        cout << " (en uso: " << kernels().nombre << ")\n\n";
+        cout << left << setw(20) << "primitiva" << setw(10) << "variante" << right
+             << setw(6) << "cols" << setw(6) << "dens" << setw(12) << "ns/op"
+             << setw(11) << "Mop/s" << setw(9) << "Gcel/s" << setw(9) << "res/op" << "\n";
+    }
+
+    for (int cols : anchos)
+        for (double dens : densidades) {
+            banco_filas(cols, dens);
+            banco_motor_ancho(cols, dens);
+            banco_matrices(cols, dens);
+        }
+
+    cerr << "\nVerificacion diferencial: " << casos << " casos, "
+         << discrepancias << " discrepancias\n";
+    return discrepancias ? 1 : 0;
+}
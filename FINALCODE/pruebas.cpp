@@ -0,0 +1,166 @@
+// Pruebas de finalcode.cpp
+// Compilar: g++ -O2 -std=c++17 -pthread pruebas.cpp -o pruebas
+// Ejecutar: ./pruebas
+//
+// Cada prueba imprime una linea con su resultado; si alguna falla el
+// programa sale con 1.
+
+#define TESTORES_SIN_MAIN
+#include "finalcode.cpp"
+
+mt19937 rng(2025);
+int fallos = 0;
+
+void reportar(const string& nombre, bool ok, const string& detalle = "") {
+    cout << (ok ? "[ ok ] " : "[FALLA] ") << nombre;
+    if (!detalle.empty()) cout << ": " << detalle;
+    cout << "\n";
+    if (!ok) fallos++;
+}
+
+// Filas sin ceros, como las de una MB
+Matriz matriz_aleatoria(int filas, int cols, double dens) {
+    bernoulli_distribution b(dens);
+    Matriz M(filas, vector<int>(cols));
+    for (auto& f : M) {
+        for (int& v : f) v = b(rng);
+        f[rng() % cols] = 1;
+    }
+    return M;
+}
+
+// ====================== REANUDACION DE YYC ============================
+
+// Con un presupuesto de 1 a 3 nodos ninguna sesion completa una fila con
+// mas activos que eso; la busqueda tiene que terminar igual reanudando
+// desde el checkpoint y dar lo mismo que sin interrumpir.
+void prueba_reanudar_yyc() {
+    const string ruta = "pruebas_checkpoint.tmp";
+    int casos = 0, sesiones_max = 0;
+    string detalle;
+
+    for (int caso = 0; caso < 40 && detalle.empty(); ++caso) {
+        int filas = 4 + rng() % 10, cols = 6 + rng() % 12;
+        Matriz MB = aMatrizBasica(matriz_aleatoria(filas, cols, 0.3 + 0.1 * (rng() % 3)));
+
+        OpcionesBusqueda libre;
+        libre.silencioso = true;
+        vector<ConjuntoBits> esperado = YYC_rapido(MB, libre);
+
+        OpcionesBusqueda op;
+        op.silencioso = true;
+        op.presupuesto_nodos = 1 + caso % 3;
+        op.checkpoint = ruta;
+        remove(ruta.c_str());
+
+        InfoBusqueda info;
+        vector<ConjuntoBits> res = YYC_rapido(MB, op, &info);
+        int sesiones = 1;
+        while (!info.completa && sesiones < 100000) {
+            int columnas;
+            res = reanudar_busqueda(ruta, op, info, columnas);
+            sesiones++;
+        }
+        sesiones_max = max(sesiones_max, sesiones);
+
+        if (!info.completa)
+            detalle = "caso " + to_string(caso) + " sin terminar tras " + to_string(sesiones) + " sesiones";
+        else if (res != esperado)
+            detalle = "caso " + to_string(caso) + " difiere de la busqueda sin interrumpir";
+        casos++;
+    }
+    remove(ruta.c_str());
+
+    bool ok = detalle.empty();
+    if (ok) detalle = to_string(casos) + " casos, hasta " + to_string(sesiones_max) + " sesiones";
+    reportar("YYC reanudado con presupuesto menor que una fila", ok, detalle);
+}
+
+// ======================== MANIFIESTO DE LOTES =========================
+
+// Un manifiesto con cada tipo de entrada documentado en leer_manifiesto()
+// y en el README: todas se leen, se construyen y dan el mismo numero de
+// testores que una busqueda directa con su algoritmo y orden. phi ya no es
+// una entrada valida.
+void prueba_manifiesto() {
+    const filesystem::path dir = "pruebas_lote.tmp";
+    filesystem::create_directories(dir);
+    {
+        ofstream m(dir / "matriz.txt");
+        m << "# matriz de prueba\n1 0 1 0 1\n0 1 1 0 0\n1 1 0 1 0\n0 0 1 1 1\n";
+    }
+    {
+        ofstream m(dir / "manifiesto.txt");
+        m << "# un tipo por linea\n"
+          << "archivo matriz.txt\n"
+          << "aleatoria 9 11 0.35 42 bt ascendente\n"
+          << "theta yyc\n"
+          << "gamma bt normal\n"
+          << "phi_n 1 ascendente\n"
+          << "gamma_n 1 bt\n";
+    }
+    {
+        ofstream m(dir / "con_phi.txt");
+        m << "phi\n";
+    }
+
+    const set<string> documentados = {"archivo", "aleatoria", "theta", "gamma", "phi_n", "gamma_n"};
+    string detalle;
+    vector<EntradaLote> entradas;
+    if (!leer_manifiesto((dir / "manifiesto.txt").string(), entradas)) {
+        detalle = "no se pudo leer el manifiesto";
+    } else {
+        set<string> tipos;
+        for (auto& e : entradas) tipos.insert(e.tipo);
+        if (tipos != documentados) detalle = "faltan tipos de entrada en la prueba";
+    }
+
+    if (detalle.empty()) {
+        ostringstream out;
+        InfoLote info = ejecutar_lote(entradas, out, 2, false);
+        if (info.fallidas != 0 || info.matrices != entradas.size())
+            detalle = to_string(info.fallidas) + " entradas fallidas";
+
+        // Un bloque por entrada, en orden, con los testores de la busqueda directa
+        istringstream in(out.str());
+        string linea;
+        size_t i = 0;
+        while (detalle.empty() && getline(in, linea)) {
+            if (linea.rfind("# filas ", 0) != 0) continue;
+            if (i >= entradas.size()) {
+                detalle = "mas bloques que entradas";
+                break;
+            }
+            const EntradaLote& e = entradas[i];
+            Matriz M;
+            construir_matriz(e, M);
+            Matriz MB = aMatrizBasica(M);
+            if (e.orden == 2) MB = ordenar_filas_por_unos(MB);
+            OpcionesBusqueda op;
+            op.silencioso = true;
+            size_t esperado = (e.alg == 1 ? YYC_rapido(MB, op) : BT_rapido(MB, op)).size();
+            size_t p = linea.find("testores ");
+            if (p == string::npos || stoul(linea.substr(p + 9)) != esperado)
+                detalle = "entrada '" + e.descripcion + "': testores distintos";
+            i++;
+        }
+        if (detalle.empty() && i != entradas.size()) detalle = "faltan bloques en la salida";
+    }
+
+    vector<EntradaLote> con_phi;
+    if (detalle.empty() && leer_manifiesto((dir / "con_phi.txt").string(), con_phi))
+        detalle = "se acepto una entrada phi";
+
+    filesystem::remove_all(dir);
+    bool ok = detalle.empty();
+    if (ok) detalle = to_string(entradas.size()) + " entradas, " + to_string(documentados.size()) + " tipos";
+    reportar("manifiesto con todos los tipos de entrada", ok, detalle);
+}
+
+int main() {
+    prueba_reanudar_yyc();
+    prueba_manifiesto();
+
+    cout << "\n" << (fallos ? to_string(fallos) + " pruebas fallaron" : "Todas las pruebas pasaron") << "\n";
+    return fallos ? 1 : 0;
+}